@@ -5,16 +5,19 @@
 #include <string>
 #include <vector>
 #include <queue>
-#include <unordered_set>
 #include <functional>
+#include <cstdint>
 #include "trie.h"
+#include "edit_cost.h"
+#include "simd_levenshtein.h"
+#include "word_signature.h"
+#include "word_frequency.h"
 
 using namespace std;
 
 // State for A* search in the Trie
 struct AStarState {
     TrieNode* node;           // Current position in Trie
-    string currentWord;       // Word built so far
     int targetIndex;          // Position in target word
     int gCost;                // Actual cost (edit distance so far)
     int fCost;                // f = g + h (total estimated cost)
@@ -25,23 +28,109 @@ struct AStarState {
     }
 };
 
+// Open-addressing map from (trie node, target index) pairs to the cheapest
+// cost seen for them. reset() bumps an epoch instead of clearing the slots, so emptying the set
+// between queries costs nothing and never gives memory back.
+class NodeStateSet {
+private:
+    struct Slot {
+        const TrieNode* node;
+        int targetIndex;
+        int cost;
+        uint32_t epoch;
+    };
+    
+    vector<Slot> slots;
+    uint32_t epoch;
+    size_t count;
+    
+    static size_t hashOf(const TrieNode* node, int targetIndex);
+    void grow();
+
+public:
+    NodeStateSet(size_t initialCapacity = 1024);
+    
+    void reset();
+    
+    // Returns true if the pair was not in the set yet, or was only reached
+    // at a higher cost before (the stored cost is then lowered)
+    bool insert(const TrieNode* node, int targetIndex, int cost = 0);
+    
+    size_t size() const { return count; }
+};
+
+// Reusable scratch space for A* queries. One context per thread: once its
+// containers reach their working size, later queries do no heap allocation.
+struct SearchContext {
+    vector<AStarState> frontier;                 // binary heap ordered by fCost
+    NodeStateSet visited;                        // expanded (node, targetIndex) pairs, by gCost
+    NodeStateSet resultSet;                      // hashed dedup of reported words
+    vector<pair<int, const TrieNode*>> results;  // (distance, word node)
+    vector<const TrieNode*> candidates;          // end-of-word nodes awaiting verification
+    vector<const string*> candidateWords;        // their words, as batch kernel input
+    vector<int> candidateDistances;              // batch kernel output
+    CandidateBatchScratch verification;          // verification kernel buffers
+    
+    SearchContext();
+};
+
 class AStarSpellChecker {
 private:
     Trie* trie;
+    const SignatureTable* signatures;  // optional pre-filter keyed by TrieNode::wordId
+    const FrequencyStore* frequencies; // optional tie-break keyed by TrieNode::wordId
+    uint8_t stopLevel;                 // frequency level that ends iterative deepening, 0 = never
+    
+    uint8_t levelOf(const TrieNode* node) const { return frequencies ? frequencies->level(node->wordId) : 0; }
+    
+    // Heuristic: unmatched target characters, an upper bound on the
+    // remaining edit distance that orders the frontier (not admissible),
+    // in Cost units
+    template<typename Cost>
+    int heuristic(int targetIndex, const string& target);
     
-    // Heuristic: estimate remaining edit distance
-    // Uses the difference in remaining characters as lower bound
-    int heuristic(const string& current, int targetIndex, const string& target);
+    // Verify collected unit-cost candidates in one-vs-many SIMD batches
+    void verifyCandidates(const string& target, int budget, SearchContext& context);
     
-    // Calculate Levenshtein distance between two strings (for verification)
-    int levenshteinDistance(const string& s1, const string& s2);
+    // One bounded search pass into context.results, budget in Cost units.
+    // The context is cleared, not reallocated, so iterative deepening reuses
+    // it for every budget
+    template<typename Cost>
+    void searchWithBudget(const string& target, int budget, SearchContext& context);
+    
+    // Copy context results out as (distance, word) pairs
+    static vector<pair<int, string>> toWordPairs(const SearchContext& context);
 
 public:
     AStarSpellChecker(Trie* t);
     
+    // Reject unit-cost candidates by signature before the verification DP
+    void setSignatureTable(const SignatureTable* table) { signatures = table; }
+    
+    // Break distance ties by corpus frequency. With earlyStopLevel > 0,
+    // iterative deepening also stops at the first budget that finds a word
+    // at least that frequent
+    void setFrequencyStore(const FrequencyStore* store, uint8_t earlyStopLevel = 0) {
+        frequencies = store;
+        stopLevel = earlyStopLevel;
+    }
+    
     // Find similar words using A* search with Levenshtein distance as cost
     // Returns words within maxDist edit distance, ordered by distance
+    // The context overloads take the edit-cost policy as a template argument
+    // (UnitCost or KeyboardCost); their distances are in that policy's units
     vector<pair<int, string>> findSimilarWords(const string& target, int maxDist);
+    template<typename Cost = UnitCost>
+    const vector<pair<int, const TrieNode*>>& findSimilarWords(const string& target, int maxDist,
+                                                             SearchContext& context);
+    
+    // Iterative deepening: search with budget 0, 1, ..., maxDist and return as
+    // soon as one budget confirms maxResults words (same top results as above),
+    // or finds a word reaching the early-stop frequency
+    vector<pair<int, string>> findSimilarWordsIterative(const string& target, int maxDist, size_t maxResults);
+    template<typename Cost = UnitCost>
+    const vector<pair<int, const TrieNode*>>& findSimilarWordsIterative(const string& target, int maxDist,
+                                                                      size_t maxResults, SearchContext& context);
     
     // Find the single best match
     string findBestMatch(const string& target, int maxDist);
@@ -14,6 +14,8 @@
 #include <mutex>
 #include <atomic>
 #include "spellchecker.h"
+#include "simd_levenshtein.h"
+#include "cascade_engine.h"
 
 using namespace std;
 
@@ -47,11 +49,13 @@ struct MethodComparison {
     double trieTimeMs;
     double kdtreeTimeMs;
     double astarTimeMs;
+    double symspellTimeMs;
     vector<string> trieSuggestions;
     vector<string> kdtreeSuggestions;
     vector<string> astarSuggestions;
+    vector<string> symspellSuggestions;
     
-    MethodComparison() : timeMs(0), trieTimeMs(0), kdtreeTimeMs(0), astarTimeMs(0) {}
+    MethodComparison() : timeMs(0), trieTimeMs(0), kdtreeTimeMs(0), astarTimeMs(0), symspellTimeMs(0) {}
 };
 
 class Benchmark {
@@ -69,6 +73,9 @@ private:
     double calculateMean(const vector<double>& values);
     double calculateStdDev(const vector<double>& values, double mean);
     
+    // (misspelling, intended word) pairs whose intended word is in the dictionary
+    vector<pair<string, string>> loadMisspellings(const string& filename);
+    
 public:
     Benchmark(SpellChecker* sc, const string& outDir = "benchmarks/results/data/");
     
@@ -79,6 +86,26 @@ public:
     void benchmarkScalability(const vector<int>& dictionarySizes);
     void benchmarkMethodComparison(const vector<string>& testWords);
     
+    // Edit-distance kernel microbenchmark over string lengths 4..256
+    void benchmarkLevenshteinKernels(int iterations = 2000);
+    void benchmarkSpecializedDistances(const vector<string>& testWords, int iterations = 20);
+    void benchmarkDistanceComputations(const vector<string>& testWords);
+    void benchmarkLongWords(int queryCount = 200);
+    void benchmarkPhoneticRecall(const string& misspellingsFile = "data/misspellings.txt");
+    void benchmarkCascade(const string& misspellingsFile = "data/misspellings.txt");
+    void benchmarkLengthPartitions(int queriesPerLength = 50);
+    void benchmarkKDTreeBuild(int queryCount = 500);
+    void benchmarkFlatKDTree(int queryCount = 500);
+    void benchmarkKDTreeNeighbours(const vector<int>& ks = {1, 5, 10, 25, 50}, int queryCount = 500);
+    void benchmarkKDTreeLeafSizes(const vector<int>& leafSizes = {4, 8, 16, 32, 64, 128}, int queryCount = 500);
+    void benchmarkKDTreeBatch(int queryCount = 5000);
+    void benchmarkKDTreeInsert(const vector<double>& balanceFactors = {1.0, 0.8, 0.7, 0.6}, int insertsPerQuery = 10);
+    void benchmarkPositionFeatures(int rounds = 20);
+    void benchmarkKDTreeApprox(const vector<int>& checks = {8, 16, 32, 64, 128, 256, 512}, int queryCount = 500);
+    void benchmarkKDTreeRerank(const string& misspellingsFile = "data/misspellings.txt");
+    void benchmarkBigramIndex(const vector<int>& dimensions = {32, 48, 64}, const vector<size_t>& checks = {500, 2000},
+                              const string& misspellingsFile = "data/misspellings.txt", int queryCount = 500);
+    
     // Parallel benchmarks
     void benchmarkParallelProcessing(const string& text, int numThreads);
     
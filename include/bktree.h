@@ -0,0 +1,39 @@
+#ifndef BKTREE_H
+#define BKTREE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "simd_levenshtein.h"
+
+using namespace std;
+
+// Burkhard-Keller tree over Levenshtein distance.
+// Every child edge is labelled with the child's distance to its parent, so
+// by the triangle inequality a query q within maxDist of some word below
+// the edge can only be found under edges with |d(q, parent) - label| <= maxDist.
+struct BKTreeNode {
+    string word;
+    // (edge distance, child node index), kept sorted by distance so the
+    // admissible range is one contiguous slice of a flat array
+    vector<pair<int, int>> children;
+};
+
+class BKTree {
+private:
+    vector<BKTreeNode> nodes;   // nodes[0] is the root
+    LevenshteinScratch insertScratch;
+
+public:
+    // Adds a word; duplicates are ignored
+    void insert(const string& word);
+    void clear() { nodes.clear(); }
+    size_t size() const { return nodes.size(); }
+
+    // All words within maxDist of query as (distance, word), unordered.
+    // distanceComputations, if given, accumulates the edit distances computed
+    void search(const string& query, int maxDist, vector<pair<int, string>>& results,
+                size_t* distanceComputations = nullptr) const;
+};
+
+#endif // BKTREE_H
@@ -0,0 +1,78 @@
+#ifndef CASCADE_ENGINE_H
+#define CASCADE_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <iostream>
+#include "spellchecker.h"
+
+using namespace std;
+
+// Hit counters for one cascade stage, as plain numbers
+struct CascadeStageStats {
+    string name;
+    uint64_t reached;    // queries that ran this stage
+    uint64_t hits;       // ... and got at least one new suggestion from it
+    uint64_t resolved;   // ... and had enough suggestions afterwards
+    double totalMs;      // time spent in this stage over all queries
+};
+
+// Hybrid engine: runs cheap exact searches first and escalates only when
+// they leave too few suggestions.
+//   1. SymSpell at distance 1 (most typos are one edit away)
+//   2. SymSpell at the checker's maxEditDistance
+//   3. Phonetic (Double Metaphone) candidates, for sound-alike spellings
+//   4. KD-tree neighbours, to fill the list when nothing else matched
+// Each stage appends words the earlier ones did not find. The cascade stops
+// once minSuggestions are found or a stage finds a word reaching the
+// checker's early-stop frequency, or before starting a stage when the word
+// has used up its latency budget.
+class CascadeEngine final : public SuggestionEngine {
+private:
+    struct Stage {
+        string name;
+        function<vector<string>(const string&)> suggest;
+        atomic<uint64_t> reached{0};
+        atomic<uint64_t> hits{0};
+        atomic<uint64_t> resolved{0};
+        atomic<uint64_t> totalNs{0};
+    };
+
+    SpellChecker& checker;
+    string engineName;
+    string engineDescription;
+    vector<unique_ptr<Stage>> stages;
+    int minSuggestions;
+    double budgetUs;
+    atomic<uint64_t> queries{0};
+    atomic<uint64_t> budgetStops{0};
+
+    void addStage(const string& name, function<vector<string>(const string&)> suggest);
+
+public:
+    explicit CascadeEngine(SpellChecker& sc, int minSugg = 3, double latencyBudgetUs = 1000.0);
+
+    const string& name() const override { return engineName; }
+    const string& description() const override { return engineDescription; }
+    vector<string> suggest(const string& word) override;
+
+    // Suggestions that count as enough to stop escalating
+    void setMinSuggestions(int count) { minSuggestions = count; }
+    int getMinSuggestions() const { return minSuggestions; }
+
+    // Per-word time after which no further stage is started
+    void setLatencyBudgetUs(double us) { budgetUs = us; }
+    double getLatencyBudgetUs() const { return budgetUs; }
+
+    // Stage counters since construction or the last reset
+    vector<CascadeStageStats> getStageStats() const;
+    uint64_t getQueryCount() const { return queries.load(); }
+    uint64_t getBudgetStops() const { return budgetStops.load(); }
+    void resetStats();
+    void printStats(ostream& out = cout) const;
+};
+
+#endif // CASCADE_ENGINE_H
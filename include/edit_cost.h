@@ -0,0 +1,118 @@
+#ifndef EDIT_COST_H
+#define EDIT_COST_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// Edit-cost policies for the search engines.
+// A policy is a template argument, never a virtual call, so the DP loops are
+// compiled once per policy. Costs are integers counted in 1/scale of an edit:
+// a budget of maxDist edits becomes maxDist * scale cost units.
+
+// Classic Levenshtein costs; the engines compile this to their plain loops
+struct UnitCost {
+    static constexpr int scale = 1;
+    static constexpr bool hasTransposition = false;
+
+    static constexpr int insertCost(char) { return 1; }
+    static constexpr int deleteCost(char) { return 1; }
+    static constexpr int substituteCost(char a, char b) { return a != b ? 1 : 0; }
+    static constexpr int transposeCost() { return 1; }
+};
+
+// Build the 26x26 QWERTY adjacency table at compile time
+constexpr array<array<uint8_t, 26>, 26> buildKeyboardAdjacency() {
+    const char* rows[3] = {"qwertyuiop", "asdfghjkl", "zxcvbnm"};
+    int rowOf[26] = {};
+    int colOf[26] = {};
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; rows[r][c] != '\0'; c++) {
+            rowOf[rows[r][c] - 'a'] = r;
+            colOf[rows[r][c] - 'a'] = c;
+        }
+    }
+
+    array<array<uint8_t, 26>, 26> adjacent = {};
+    for (int a = 0; a < 26; a++) {
+        for (int b = 0; b < 26; b++) {
+            int dr = rowOf[b] - rowOf[a];
+            int dc = colOf[b] - colOf[a];
+            // Rows are staggered: the row above sits half a key to the right
+            bool sameRow = dr == 0 && (dc == 1 || dc == -1);
+            bool rowAbove = dr == -1 && (dc == 0 || dc == 1);
+            bool rowBelow = dr == 1 && (dc == 0 || dc == -1);
+            adjacent[a][b] = (sameRow || rowAbove || rowBelow) ? 1 : 0;
+        }
+    }
+    return adjacent;
+}
+
+// Typo-aware costs: hitting a neighbouring key or swapping two adjacent
+// letters costs half an edit, everything else costs a full edit
+struct KeyboardCost {
+    static constexpr int scale = 2;
+    static constexpr bool hasTransposition = true;
+
+    static constexpr array<array<uint8_t, 26>, 26> substitution = [] {
+        array<array<uint8_t, 26>, 26> costs = {};
+        array<array<uint8_t, 26>, 26> adjacent = buildKeyboardAdjacency();
+        for (int a = 0; a < 26; a++) {
+            for (int b = 0; b < 26; b++) {
+                costs[a][b] = a == b ? 0 : (adjacent[a][b] ? 1 : 2);
+            }
+        }
+        return costs;
+    }();
+
+    static constexpr int insertCost(char) { return 2; }
+    static constexpr int deleteCost(char) { return 2; }
+    static int substituteCost(char a, char b) {
+        unsigned ia = static_cast<unsigned char>(a) - 'a';
+        unsigned ib = static_cast<unsigned char>(b) - 'a';
+        if (ia < 26 && ib < 26) return substitution[ia][ib];
+        return a != b ? 2 : 0;
+    }
+    static constexpr int transposeCost() { return 1; }
+};
+
+// Runtime selector used by SpellChecker; resolved to a policy once per query
+enum class EditCostModel { Unit, Keyboard };
+
+// Weighted edit distance (optimal string alignment when the policy allows
+// transpositions), in the policy's cost units
+template<typename Cost>
+int weightedEditDistance(const string& s1, const string& s2) {
+    int m = s1.length();
+    int n = s2.length();
+
+    vector<int> prevPrev(n + 1), prev(n + 1), curr(n + 1);
+    for (int j = 0; j <= n; j++) {
+        prev[j] = j == 0 ? 0 : prev[j - 1] + Cost::insertCost(s2[j - 1]);
+    }
+
+    for (int i = 1; i <= m; i++) {
+        curr[0] = prev[0] + Cost::deleteCost(s1[i - 1]);
+        for (int j = 1; j <= n; j++) {
+            curr[j] = min({prev[j] + Cost::deleteCost(s1[i - 1]),
+                           curr[j - 1] + Cost::insertCost(s2[j - 1]),
+                           prev[j - 1] + Cost::substituteCost(s1[i - 1], s2[j - 1])});
+            if constexpr (Cost::hasTransposition) {
+                if (i > 1 && j > 1 && s1[i - 1] == s2[j - 2] && s1[i - 2] == s2[j - 1] &&
+                    s1[i - 1] != s1[i - 2]) {
+                    curr[j] = min(curr[j], prevPrev[j - 2] + Cost::transposeCost());
+                }
+            }
+        }
+        prevPrev.swap(prev);
+        prev.swap(curr);
+    }
+
+    return prev[n];
+}
+
+#endif // EDIT_COST_H
@@ -0,0 +1,116 @@
+#ifndef FLAT_KDTREE_H
+#define FLAT_KDTREE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "kdtree.h"
+
+using namespace std;
+
+// Static kd-tree over the same word positions as KDTree, stored as an
+// implicit array: node i has children 2i + 1 and 2i + 2, so there are no
+// child pointers. The tree is left-balanced (complete), which keeps the
+// n nodes in slots 0..n-1. Coordinates are floats kept structure of
+// arrays, one array per dimension, and each node refers to its word by
+// id; a distance computation reads five floats instead of chasing a
+// node, a vector and a string.
+class FlatKDTree {
+public:
+    static const size_t DIMENSIONS = 5;
+
+private:
+    vector<float> coords[DIMENSIONS];   // coords[d][node]
+    vector<int> ids;                    // word id per node
+    vector<string> words;               // word per id
+
+    struct Point {
+        float coords[DIMENSIONS];
+        int id;
+    };
+
+    void buildRecursive(vector<Point>& points, size_t begin, size_t end, size_t node, size_t depth);
+    void kNearestRecursive(size_t node, size_t depth, const float* target,
+                           vector<pair<float, int>>& heap, size_t k, size_t& visited) const;
+
+public:
+    // Replace the tree with one over words (ids are positions in the vector)
+    void build(const vector<string>& words);
+    void clear();
+
+    // Same results as KDTree::findKNearest: the k nearest positions,
+    // closest first, ties alphabetical (distances are computed in float).
+    // visited, when given, receives the nodes examined
+    vector<Position> findKNearest(const string& target_word, size_t k, size_t* visited = nullptr) const;
+
+    size_t size() const { return ids.size(); }
+    // Bytes in the node arrays, not counting the word strings
+    size_t memoryBytes() const;
+};
+
+// Static kd-tree with point buckets at the leaves. Inner nodes only hold
+// a split (axis, value); each leaf owns up to leafSize points stored
+// contiguously, structure of arrays, so a query scans a whole leaf with a
+// vectorized squared-distance loop instead of following a pointer per
+// point. Inner nodes split on the axis with the largest spread and sit in
+// an implicit array like FlatKDTree's.
+class BucketKDTree {
+public:
+    static const size_t DIMENSIONS = FlatKDTree::DIMENSIONS;
+    // Picked with Benchmark::benchmarkKDTreeLeafSizes
+    static const size_t DEFAULT_LEAF_SIZE = 32;
+
+private:
+    struct Node {
+        float split;
+        uint32_t axis;
+        uint32_t begin, end;   // points under this node, in leaf order
+    };
+
+    size_t leafSize;
+    vector<Node> nodes;                 // node i has children 2i + 1 and 2i + 2
+    vector<float> coords[DIMENSIONS];   // coords[d][point], points in leaf order
+    vector<int> ids;                    // word id per point
+    vector<string> words;               // word per id
+
+    void buildRecursive(vector<uint32_t>& order, const vector<float>* source, size_t begin, size_t end, size_t node);
+    // One query of a batch
+    struct BatchQuery {
+        float target[DIMENSIONS];
+        vector<pair<float, int>> heap;   // k best (squared distance, id), worst on top
+    };
+
+    void scanLeaf(const Node& leaf, const float* target, vector<pair<float, int>>& heap, size_t k) const;
+    void kNearestRecursive(size_t node, const float* target, vector<pair<float, int>>& heap,
+                           size_t k, size_t& scanned) const;
+    // Walk node with the queries in active, which all still need it
+    void batchRecursive(size_t node, vector<BatchQuery>& queries, const vector<uint32_t>& active, size_t k) const;
+
+public:
+    explicit BucketKDTree(size_t leafSize = DEFAULT_LEAF_SIZE);
+
+    // Replace the tree with one over words (ids are positions in the vector)
+    void build(const vector<string>& words);
+    void clear();
+
+    // Same results as KDTree::findKNearest, ties alphabetical (distances
+    // are computed in float). scanned, when given, receives the number of
+    // points whose distance was computed
+    vector<Position> findKNearest(const string& target_word, size_t k, size_t* scanned = nullptr) const;
+
+    // findKNearest for every target, walking the tree once per batch: the
+    // queries split into groups at each node by the side they take, and
+    // each leaf is scanned for its whole group while it is in cache. With
+    // threads > 1 the batch is split into that many slices of nearby
+    // queries, walked in parallel
+    vector<vector<Position>> findKNearestBatch(const vector<string>& targets, size_t k, int threads = 1) const;
+
+    // Takes effect at the next build
+    void setLeafSize(size_t size) { leafSize = max<size_t>(1, size); }
+    size_t getLeafSize() const { return leafSize; }
+    size_t size() const { return ids.size(); }
+    size_t memoryBytes() const;
+};
+
+#endif // FLAT_KDTREE_H
@@ -11,6 +11,8 @@ using namespace std;
 
 // position of word in tree (calculates distance)
 struct Position {
+    static const size_t DIMENSIONS = 5;
+
     string word;
     vector<double> coords;
 
@@ -21,6 +23,18 @@ struct Position {
 
     // convert word to position object
     static Position fromWord(const string& word);
+
+    // The same coordinates written to a caller's array, with no copy of the
+    // word and no allocation. A constexpr table packs each byte's four
+    // class counts into one word, so a character costs one lookup and one
+    // add, with no branches
+    static void fromWord(const string& word, double coords[DIMENSIONS]);
+    static void fromWord(const string& word, float coords[DIMENSIONS]);
+
+    // Coordinates of many words, coords[d][i] for word i, as the column
+    // arrays the static kd-trees store; large batches are split over
+    // OpenMP threads
+    static void fromWords(const vector<string>& words, float* const coords[DIMENSIONS]);
 };
 
 // kd-tree node
@@ -36,21 +50,61 @@ class KDTree {
 private:
     KDTreeNode* root;
     size_t dimensions;
+    size_t nodeCount;
+    double balanceFactor;
+    size_t rebuildCount;
 
-    KDTreeNode* insertRecursive(KDTreeNode* node, const Position& pos, size_t depth);
+    KDTreeNode* buildRecursive(vector<Position>& positions, size_t begin, size_t end, size_t depth);
     void clearRecursive(KDTreeNode* node);
-    void kNearestRecursive(KDTreeNode* node, const Position& target, size_t depth,
-                           vector<pair<double, Position>>& candidates, size_t k);
+    size_t depthRecursive(const KDTreeNode* node) const;
+    size_t countRecursive(const KDTreeNode* node) const;
+    // Moves the subtree's positions into out and frees its nodes
+    void flattenRecursive(KDTreeNode* node, vector<Position>& out);
+    // Replace the subtree in slot, whose root sits at depth, with a median-split one
+    void rebuildSubtree(KDTreeNode** slot, size_t depth);
+    // heap: the k best (squared distance, node) pairs so far, worst on top
+    void kNearestRecursive(const KDTreeNode* node, const Position& target, size_t depth,
+                           vector<pair<double, const KDTreeNode*>>& heap, size_t k, size_t& visited) const;
 
 public:
+    static constexpr double DEFAULT_BALANCE_FACTOR = 0.7;
+
     KDTree();
     ~KDTree();
 
+    // Scapegoat insertion: when the new node lands deeper than
+    // log(n) / log(1 / balanceFactor), the first ancestor walking up from
+    // it whose child holds more than balanceFactor of its subtree is rebuilt
+    // with median splits. Depth stays O(log n) under any insertion order,
+    // at amortized O(log^2 n) per insert
     void insert(const string word);
-    vector<Position> findKNearest(const string target_word, size_t k);
+    // 0.5 < factor < 1; 1 turns rebalancing off
+    void setBalanceFactor(double factor) { balanceFactor = factor; }
+    double getBalanceFactor() const { return balanceFactor; }
+    // Subtrees rebuilt by insert since construction
+    size_t getRebuildCount() const { return rebuildCount; }
+    
+    // Replace the tree with a balanced one over words: every node splits its
+    // subtree at the median of its axis (nth_element), so the depth is
+    // ceil(log2(n + 1)) whatever order the words come in. Large subtrees
+    // are built in parallel OpenMP tasks
+    void build(const vector<string>& words);
+    void clear();
+    // visited, when given, receives the number of nodes examined
+    vector<Position> findKNearest(const string target_word, size_t k, size_t* visited = nullptr);
+    
+    // Best-bin-first approximate search: branches not taken wait in a
+    // priority queue ordered by their distance bound, and the search
+    // examines at most maxChecks nodes, closest branches first. Exact
+    // when the queue runs out first; maxChecks 0 means no limit
+    vector<Position> findKNearestApprox(const string target_word, size_t k, size_t maxChecks,
+                                        size_t* visited = nullptr);
     
     // Get dimensions count
     size_t getDimensions() const { return dimensions; }
+    size_t size() const { return nodeCount; }
+    // Nodes on the longest root-to-leaf path
+    size_t depth() const { return depthRecursive(root); }
 };
 
 #endif // KDTREE_H
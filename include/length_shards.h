@@ -0,0 +1,57 @@
+#ifndef LENGTH_SHARDS_H
+#define LENGTH_SHARDS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "trie.h"
+#include "kdtree.h"
+
+using namespace std;
+
+// Dictionary partitioned by word length, one trie and one kd-tree per
+// length. Every edit changes the length by at most one, so a query of
+// length n within maxDist edits can only match words of length
+// n - maxDist .. n + maxDist: searches touch those 2 * maxDist + 1 shards
+// and skip the rest of the dictionary. The shards are independent and can
+// be searched in parallel.
+class LengthShardedIndex {
+private:
+    struct Shard {
+        Trie trie;
+        KDTree kdtree;
+        size_t words = 0;
+    };
+
+    vector<unique_ptr<Shard>> shards;   // indexed by word length
+    size_t wordCount;
+    bool parallel;
+
+    // Non-empty shards for lengths within maxDist of length
+    vector<Shard*> shardsFor(size_t length, int maxDist) const;
+
+public:
+    // Unit-cost trie search run on each shard (same signature as the
+    // SpellChecker's dispatch pointer)
+    using TrieSearch = vector<string> (*)(Trie& trie, const string& word, int maxDist);
+
+    LengthShardedIndex();
+
+    void insert(const string& word, int wordId = -1);
+    void clear();
+
+    // Words within maxDist edits, shard by shard from the shortest length
+    vector<string> getSimilarWords(const string& word, int maxDist, TrieSearch search);
+
+    // k nearest kd-tree neighbours among words of length n +- maxDist
+    vector<Position> findKNearest(const string& word, size_t k, int maxDist);
+
+    // Search the relevant shards in OpenMP threads (off by default)
+    void setParallel(bool enabled) { parallel = enabled; }
+    bool getParallel() const { return parallel; }
+
+    size_t size() const { return wordCount; }
+    size_t shardCount() const;
+};
+
+#endif // LENGTH_SHARDS_H
@@ -15,6 +15,7 @@ class ParallelSpellChecker {
 private:
     SpellChecker* checker;
     int numThreads;
+    vector<SearchContext> contexts;  // one A* search context per thread
     
     // Helper to split text into words
     vector<string> tokenize(const string& text);
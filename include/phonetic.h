@@ -0,0 +1,43 @@
+#ifndef PHONETIC_H
+#define PHONETIC_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Double Metaphone (Lawrence Philips, 2000).
+// Encodes how an English word sounds as up to four consonant-class letters.
+// Words with an ambiguous pronunciation get a second, alternate code
+// (equal to the primary when there is no ambiguity).
+struct PhoneticCode {
+    string primary;
+    string alternate;
+};
+
+PhoneticCode doubleMetaphone(const string& word, size_t maxLength = 4);
+
+// Word ids grouped by phonetic code. Both codes of every word are indexed,
+// so a lookup with both codes of the query also finds words that only
+// sound alike under the alternate pronunciation.
+class PhoneticIndex {
+private:
+    // Codes packed into one integer, sorted; ids[i] belongs to keys[i]
+    vector<uint32_t> keys;
+    vector<int> ids;
+
+    static uint32_t pack(const string& code);
+
+public:
+    // Index words (ids are positions in the vector)
+    void build(const vector<string>& words);
+
+    // Ids of all words sharing a code with the query, each reported once
+    void lookup(const string& query, vector<int>& result) const;
+
+    size_t size() const { return keys.size(); }
+    size_t memoryBytes() const { return keys.capacity() * sizeof(uint32_t) + ids.capacity() * sizeof(int); }
+};
+
+#endif // PHONETIC_H
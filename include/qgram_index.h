@@ -0,0 +1,56 @@
+#ifndef QGRAM_INDEX_H
+#define QGRAM_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Inverted index from character q-grams to the words containing them.
+// Words are padded with q - 1 boundary symbols on each side, giving
+// len + q - 1 grams per word. One edit destroys at most q grams, so two
+// words within k edits share at least
+//   max(len(a), len(b)) + q - 1 - q * k
+// grams (counted with multiplicity). Lookups count shared grams per word
+// and keep only words reaching that bound; callers verify the survivors.
+//
+// Grams over 'a'..'z' plus the pad symbol are coded in base 27 and index a
+// flat offset table, so there is no hashing. Each posting list is a byte
+// stream of varints: (idDelta << 1 | repeated), followed by the gram's
+// multiplicity in the word when the low bit is set.
+class QGramIndex {
+private:
+    int q;
+    int gramCount;               // 27^q
+    vector<uint32_t> offsets;    // gramCount + 1 offsets into postings
+    vector<uint8_t> postings;
+    vector<uint8_t> lengths;     // word lengths, clamped to 255
+    size_t postingCount;
+
+    void gramsOf(const string& word, vector<int>& grams) const;
+
+public:
+    // Per-thread lookup buffers, reused across queries
+    struct LookupContext {
+        vector<int> grams;
+        vector<uint16_t> shared;   // shared-gram count per word id
+        vector<int> touched;       // ids with a non-zero count
+    };
+
+    explicit QGramIndex(int q = 2);
+
+    // Index words (ids are positions in the vector)
+    void build(const vector<string>& words);
+
+    // Ids of all words passing the length and count filters for maxDist
+    void lookup(const string& query, int maxDist, vector<int>& ids, LookupContext& context) const;
+
+    int getQ() const { return q; }
+    size_t size() const { return lengths.size(); }
+    size_t memoryBytes() const;
+    // Size the postings would take as plain 32-bit ids
+    size_t uncompressedBytes() const { return postingCount * sizeof(uint32_t); }
+};
+
+#endif // QGRAM_INDEX_H
@@ -0,0 +1,63 @@
+#ifndef SIMD_LEVENSHTEIN_H
+#define SIMD_LEVENSHTEIN_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Anti-diagonal Levenshtein kernels.
+// All cells of one anti-diagonal depend only on the two previous diagonals,
+// so a whole diagonal is computed per vector instruction: 32 (AVX2) or 16
+// (SSE4.1) saturating uint8_t lanes when both strings are shorter than 255
+// characters, half as many uint16_t lanes for longer strings.
+enum class LevenshteinKernel { Scalar, SSE41, AVX2 };
+
+// Diagonal and padded-string buffers. Reusing one per thread keeps the
+// kernels allocation-free once the buffers have grown to the longest input.
+struct LevenshteinScratch {
+    vector<uint8_t> diag8;
+    vector<uint16_t> diag16;
+    vector<char> s1Padded;
+    vector<char> s2Reversed;
+    vector<int> rows;          // scalar two-row fallback
+};
+
+// Best kernel for this CPU, detected once from CPUID at program start
+LevenshteinKernel activeLevenshteinKernel();
+// Also the CPU feature query for the other AVX2 paths (signature scan)
+bool levenshteinKernelSupported(LevenshteinKernel kernel);
+const char* levenshteinKernelName(LevenshteinKernel kernel);
+
+// Edit distance with the active kernel (short words use the scalar kernel)
+int simdLevenshtein(const string& s1, const string& s2);
+int simdLevenshtein(const string& s1, const string& s2, LevenshteinScratch& scratch);
+
+// Edit distance with a specific kernel (unsupported kernels fall back to scalar)
+int levenshteinWithKernel(LevenshteinKernel kernel, const string& s1, const string& s2,
+                          LevenshteinScratch& scratch);
+
+// One-vs-many verification.
+// Checks one target against up to 32 candidates per pass, one candidate per
+// SIMD lane, with the candidates packed column-major (character j of every
+// candidate side by side). Meant for filtering and ranking the candidate
+// sets produced by the trie, kd-tree and A* engines.
+struct CandidateBatchScratch {
+    vector<uint8_t> columns;    // packed candidate characters, [j * lanes + lane]
+    vector<uint8_t> rows;       // one DP row: a vector of lanes per column
+    LevenshteinScratch single;  // inputs too long for uint8_t lanes
+};
+
+// distances[i] = edit distance from target to *candidates[i]. With bound >= 0,
+// anything farther than bound is reported as bound + 1, which lets a batch
+// stop early once every lane is out of range.
+void batchLevenshtein(const string& target, const vector<const string*>& candidates,
+                      vector<int>& distances, CandidateBatchScratch& scratch, int bound = -1);
+
+// Candidates within maxDist (all of them if maxDist < 0) as (distance, word),
+// closest first; ties keep their input order
+vector<pair<int, string>> rankCandidatesByDistance(const string& target, const vector<string>& candidates,
+                                                  int maxDist = -1);
+
+#endif // SIMD_LEVENSHTEIN_H
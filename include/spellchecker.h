@@ -9,9 +9,23 @@
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <type_traits>
 #include "trie.h"
 #include "kdtree.h"
+#include "flat_kdtree.h"
+#include "vptree.h"
 #include "astar_spellcheck.h"
+#include "word_signature.h"
+#include "symspell.h"
+#include "bktree.h"
+#include "qgram_index.h"
+#include "phonetic.h"
+#include "suggestion_engine.h"
+#include "word_frequency.h"
+#include "length_shards.h"
 
 using namespace std;
 
@@ -21,7 +35,7 @@ struct SpellingError {
     int position;               // Position in text (word index)
     int lineNumber;             // Line number in text
     vector<string> suggestions; // Suggested corrections
-    string method;              // "trie", "kdtree", or "astar"
+    string method;              // name of the engine that made the suggestions
 };
 
 // Result of spell checking a text
@@ -38,8 +52,57 @@ private:
     Trie* trie;
     KDTree* kdtree;
     AStarSpellChecker* astarChecker;
+    BKTree* bktree;
+    unique_ptr<LengthShardedIndex> shards;  // per-length trie and kd-tree, null unless partitioned
+    vector<unique_ptr<SuggestionEngine>> engines;  // registration order, first is the default
+    SignatureTable signatures;      // one entry per dictionary word, id = TrieNode::wordId
+    FrequencyStore frequencies;     // corpus frequency per word id, for tie-breaking
+    uint8_t earlyStopLevel;         // frequency level that ends a search early, 0 = never
+    
+    // Bulk-built indexes over the same word ids, rebuilt on their first
+    // query after the dictionary changes
+    SymSpellIndex symspell;
+    QGramIndex qgrams;
+    PhoneticIndex phonetics;
+    BucketKDTree bucketKdtree;
+    VPTree bigramTree;
+    mutex indexMutex;
+    atomic<bool> symspellStale;
+    atomic<bool> qgramStale;
+    atomic<bool> phoneticStale;
+    atomic<bool> bucketKdtreeStale;
+    atomic<bool> bigramTreeStale;
     int maxEditDistance;
     int maxSuggestions;
+    bool astarIterativeDeepening;   // deepen the A* budget 0..maxEditDistance
+    EditCostModel costModel;        // edit costs used by the trie and A* searches
+    bool phoneticMerge;             // merge sound-alike candidates into checkText suggestions
+    bool bucketKdtreeSearch;        // kd-tree queries use the bucketed implicit-array tree
+    size_t kdtreeChecks;            // node budget for approximate kd-tree queries, 0 = exact
+    bool kdtreeRerank;              // re-rank over-fetched kd-tree neighbours by edit distance
+    bool kdtreeBigrams;             // kd-tree method searches the bigram VP-tree instead
+    
+    // Unit-cost trie search, picked once in the constructor: the banded
+    // kernel specialized for maxEditDistance 1-3, the generic DP otherwise
+    vector<string> (*unitTrieSearch)(Trie& trie, const string& word, int maxDist);
+    
+    // Order suggestions closest first under the active cost model
+    void rankByCostModel(const string& word, vector<string>& suggestions);
+    
+    // k nearest (distance, word) pairs, closest first, from whichever
+    // index the kd-tree method is configured to use
+    vector<pair<double, string>> kdtreeNeighbours(const string& word, size_t k);
+    
+    // Over-fetch kd-tree neighbours, keep the closest by edit distance
+    vector<string> rerankKDTreeNeighbours(const string& word);
+    
+    // Verify candidate word ids against maxDist (maxEditDistance when negative),
+    // closest maxSuggestions first
+    vector<string> verifyCandidateIds(const string& word, const vector<int>& ids, int maxDist = -1);
+    
+    // The maxSuggestions best (distance, word id) pairs: closest first, ties
+    // to the more frequent word, then alphabetical
+    vector<string> topSuggestions(vector<pair<int, int>>& ranked);
     
     // Text processing helpers
     string toLowerCase(const string& str);
@@ -56,15 +119,99 @@ public:
     void addWord(const string& word);
     bool isValidWord(const string& word);
     int getDictionarySize() const;
+    int getMaxEditDistance() const { return maxEditDistance; }
+    int getMaxSuggestions() const { return maxSuggestions; }
+    
+    // Word frequencies: "word count" lines from a file (see countCorpusWords),
+    // or set one at a time. Words outside the dictionary are ignored
+    bool loadFrequencies(const string& filename);
+    void setWordFrequency(const string& word, uint64_t count);
+    int getWordFrequencyLevel(const string& word);
+    const FrequencyStore& getFrequencyStore() const { return frequencies; }
+    
+    // Stop searching once a candidate this frequent is found (0 = off).
+    // Used by A* iterative deepening and the cascade's stages
+    void setEarlyStopFrequency(uint8_t level);
+    uint8_t getEarlyStopFrequency() const { return earlyStopLevel; }
+    
+    // Suggestion engines. The built-in methods are registered by the
+    // constructor; registering a name again replaces that engine
+    void registerEngine(unique_ptr<SuggestionEngine> engine);
+    SuggestionEngine* findEngine(const string& name) const;   // nullptr if unknown
+    SuggestionEngine& getEngine(const string& name) const;    // default engine if unknown
+    const vector<unique_ptr<SuggestionEngine>>& getEngines() const { return engines; }
     
     // Spell checking methods
     SpellCheckResult checkText(const string& text, const string& method = "astar");
     SpellCheckResult checkFile(const string& filename, const string& method = "astar");
     
+    // Check with a given engine. With a final engine type (TrieEngine, ...)
+    // the per-word suggest call is bound at compile time
+    template<typename Engine, typename = enable_if_t<is_base_of_v<SuggestionEngine, Engine>>>
+    SpellCheckResult checkText(const string& text, Engine& engine);
+    
     // Get suggestions for a single word
     vector<string> getSuggestionsTrie(const string& word);
     vector<string> getSuggestionsKDTree(const string& word);
+    // getSuggestionsKDTree for many words: one walk of the static kd-tree
+    // split over threads when bucket search is on, otherwise (or with length
+    // partitioning, re-ranking, bigrams or a check budget) word by word
+    vector<vector<string>> getSuggestionsKDTreeBatch(const vector<string>& words, int threads = 1);
     vector<string> getSuggestionsAStar(const string& word);
+    vector<string> getSuggestionsAStar(const string& word, SearchContext& context);
+    // Brute force over the whole dictionary: signature scan, then batched DP
+    vector<string> getSuggestionsScan(const string& word);
+    vector<string> getSuggestionsSymSpell(const string& word);
+    // Verified against maxDist (at most maxEditDistance, the index's depth)
+    vector<string> getSuggestionsSymSpell(const string& word, int maxDist);
+    vector<string> getSuggestionsBKTree(const string& word);
+    vector<string> getSuggestionsQGram(const string& word);
+    // Dictionary words with the same Double Metaphone code, closest first
+    vector<string> getPhoneticCandidates(const string& word);
+    // Add sound-alike candidates missing from a method's suggestions
+    void mergePhoneticCandidates(const string& word, vector<string>& suggestions);
+    
+    // A* search mode (iterative deepening is on by default)
+    void setAStarIterativeDeepening(bool enabled) { astarIterativeDeepening = enabled; }
+    bool getAStarIterativeDeepening() const { return astarIterativeDeepening; }
+    
+    // Length-partitioned trie and kd-tree searches (off by default). Enabling
+    // builds one sub-index per word length; parallelShards searches the
+    // relevant shards in OpenMP threads
+    void setLengthPartitioning(bool enabled, bool parallelShards = false);
+    bool getLengthPartitioning() const { return shards != nullptr; }
+    
+    // Answer kd-tree queries from the static implicit-array tree with
+    // bucketed leaves (off by default). It is rebuilt on the first query
+    // after words are added
+    void setBucketKDTreeSearch(bool enabled) { bucketKdtreeSearch = enabled; }
+    bool getBucketKDTreeSearch() const { return bucketKdtreeSearch; }
+    
+    // Bound queries on the pointer kd-tree (or the bigram VP-tree) to this
+    // many node checks with a best-first search (0, the default, searches
+    // exactly)
+    void setKDTreeChecks(size_t checks) { kdtreeChecks = checks; }
+    size_t getKDTreeChecks() const { return kdtreeChecks; }
+    
+    // Fetch several times maxSuggestions kd-tree neighbours and keep the
+    // ones closest in edit distance (more when the neighbours' distances
+    // are too close together to tell apart)
+    void setKDTreeRerank(bool enabled) { kdtreeRerank = enabled; }
+    bool getKDTreeRerank() const { return kdtreeRerank; }
+    
+    // Answer the kd-tree method from a VP-tree over hashed character-bigram
+    // vectors of the given size instead of the 5-D positions (off by
+    // default). Built on the first query; the re-ranking above still applies
+    void setKDTreeBigrams(bool enabled, int dimensions = HashedBigramEmbedding::DEFAULT_DIMENSIONS);
+    bool getKDTreeBigrams() const { return kdtreeBigrams; }
+    
+    // Edit-cost model for the trie and A* searches (unit costs by default)
+    void setCostModel(EditCostModel model) { costModel = model; }
+    EditCostModel getCostModel() const { return costModel; }
+    
+    // Phonetic candidates in checkText suggestions (off by default)
+    void setPhoneticMerge(bool enabled) { phoneticMerge = enabled; }
+    bool getPhoneticMerge() const { return phoneticMerge; }
     
     // Compare all methods
     void compareMethodsForWord(const string& word);
@@ -73,6 +220,112 @@ public:
     Trie* getTriePtr() { return trie; }
     KDTree* getKDTreePtr() { return kdtree; }
     AStarSpellChecker* getAStarPtr() { return astarChecker; }
+    BKTree* getBKTreePtr() { return bktree; }
+    const SignatureTable& getSignatureTable() const { return signatures; }
+    const SymSpellIndex& getSymSpellIndex();
+    const QGramIndex& getQGramIndex();
+    const PhoneticIndex& getPhoneticIndex();
+    const BucketKDTree& getBucketKDTree();
+    const VPTree& getBigramTree();
+};
+
+// Engine over one SpellChecker suggestion method
+template<vector<string> (SpellChecker::*Suggest)(const string&)>
+class MethodEngine final : public SuggestionEngine {
+private:
+    SpellChecker& checker;
+    string engineName;
+    string engineDescription;
+    
+public:
+    MethodEngine(SpellChecker& sc, const string& name, const string& description)
+        : checker(sc), engineName(name), engineDescription(description) {}
+    
+    const string& name() const override { return engineName; }
+    const string& description() const override { return engineDescription; }
+    vector<string> suggest(const string& word) override { return (checker.*Suggest)(word); }
+};
+
+// A* engine: the context overload runs in the caller's SearchContext
+class AStarEngine final : public SuggestionEngine {
+private:
+    SpellChecker& checker;
+    string engineName;
+    string engineDescription;
+    
+public:
+    AStarEngine(SpellChecker& sc, const string& name, const string& description)
+        : checker(sc), engineName(name), engineDescription(description) {}
+    
+    const string& name() const override { return engineName; }
+    const string& description() const override { return engineDescription; }
+    vector<string> suggest(const string& word) override { return checker.getSuggestionsAStar(word); }
+    vector<string> suggest(const string& word, SearchContext& context) override {
+        return checker.getSuggestionsAStar(word, context);
+    }
+};
+
+// kd-tree engine: batches go through getSuggestionsKDTreeBatch
+class KDTreeEngine final : public SuggestionEngine {
+private:
+    SpellChecker& checker;
+    string engineName;
+    string engineDescription;
+    
+public:
+    KDTreeEngine(SpellChecker& sc, const string& name, const string& description)
+        : checker(sc), engineName(name), engineDescription(description) {}
+    
+    const string& name() const override { return engineName; }
+    const string& description() const override { return engineDescription; }
+    vector<string> suggest(const string& word) override { return checker.getSuggestionsKDTree(word); }
+    vector<vector<string>> suggestBatch(const vector<string>& words, vector<SearchContext>& contexts) override {
+        return checker.getSuggestionsKDTreeBatch(words, static_cast<int>(contexts.size()));
+    }
 };
 
+using TrieEngine = MethodEngine<&SpellChecker::getSuggestionsTrie>;
+using SymSpellEngine = MethodEngine<&SpellChecker::getSuggestionsSymSpell>;
+using BKTreeEngine = MethodEngine<&SpellChecker::getSuggestionsBKTree>;
+using QGramEngine = MethodEngine<&SpellChecker::getSuggestionsQGram>;
+
+template<typename Engine, typename>
+SpellCheckResult SpellChecker::checkText(const string& text, Engine& engine) {
+    SpellCheckResult result;
+    result.totalWords = 0;
+    result.correctWords = 0;
+    result.incorrectWords = 0;
+    
+    auto startTime = chrono::high_resolution_clock::now();
+    
+    vector<pair<string, int>> tokens = tokenizeWithLineNumbers(text);
+    result.totalWords = tokens.size();
+    
+    int position = 0;
+    for (const auto& [word, lineNum] : tokens) {
+        if (!isValidWord(word)) {
+            SpellingError error;
+            error.originalWord = word;
+            error.position = position;
+            error.lineNumber = lineNum;
+            error.method = engine.name();
+            error.suggestions = engine.suggest(word);
+            if (phoneticMerge) {
+                mergePhoneticCandidates(word, error.suggestions);
+            }
+            
+            result.errors.push_back(error);
+            result.incorrectWords++;
+        } else {
+            result.correctWords++;
+        }
+        position++;
+    }
+    
+    auto endTime = chrono::high_resolution_clock::now();
+    result.processingTimeMs = chrono::duration<double, milli>(endTime - startTime).count();
+    
+    return result;
+}
+
 #endif // SPELLCHECKER_H
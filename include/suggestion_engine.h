@@ -0,0 +1,37 @@
+#ifndef SUGGESTION_ENGINE_H
+#define SUGGESTION_ENGINE_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct SearchContext;
+
+// A source of spelling suggestions. Engines are registered with a
+// SpellChecker by name; callers resolve the name once per check and then
+// call suggest for every misspelled word. suggest may be called from
+// several threads at once.
+class SuggestionEngine {
+public:
+    virtual ~SuggestionEngine() = default;
+
+    // Method name used on the command line and in SpellingError::method
+    virtual const string& name() const = 0;
+    // One-line summary for menus
+    virtual const string& description() const = 0;
+
+    virtual vector<string> suggest(const string& word) = 0;
+    // Same, with scratch space owned by the calling thread. Engines that
+    // need none ignore it
+    virtual vector<string> suggest(const string& word, SearchContext& context) {
+        (void)context;
+        return suggest(word);
+    }
+    // Suggestions for many words, split over one thread per context
+    // (contexts must not be empty). Engines that can share work between
+    // words override it
+    virtual vector<vector<string>> suggestBatch(const vector<string>& words, vector<SearchContext>& contexts);
+};
+
+#endif // SUGGESTION_ENGINE_H
@@ -0,0 +1,59 @@
+#ifndef SYMSPELL_H
+#define SYMSPELL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Symmetric delete index (SymSpell).
+// Every dictionary word is stored under all strings obtained by deleting up
+// to maxDist of its characters. Two words within maxDist edits always share
+// such a deletion, so a lookup only has to hash the query's own deletions;
+// no dictionary walk and no per-character DP happen before verification.
+//
+// Keys are stored as 64-bit hashes, not strings: a hash collision can only
+// add a candidate, which the caller's edit-distance check then removes.
+// Postings are one flat array of word ids (CSR), addressed from an
+// open-addressing table of (hash, begin, count) entries.
+class SymSpellIndex {
+private:
+    struct Entry {
+        uint64_t hash;
+        uint32_t begin;    // first posting in postings
+        uint32_t count;    // 0 marks an empty slot
+    };
+
+    vector<Entry> table;
+    vector<int> postings;
+    int maxDist;
+    size_t wordCount;
+
+    static uint64_t hashOf(const string& key);
+    const Entry* find(uint64_t hash) const;
+
+public:
+    // Per-thread lookup buffers, reused across queries
+    struct LookupContext {
+        vector<string> deletes;
+        vector<uint32_t> seen;   // epoch stamp per word id
+        uint32_t epoch = 0;
+    };
+
+    SymSpellIndex();
+
+    // Index words (ids are positions in the vector) for queries up to maxDist
+    void build(const vector<string>& words, int maxDist);
+
+    // Ids of all words sharing a deletion with the query, each reported once.
+    // A superset of the words within maxDist edits; callers verify them
+    void lookup(const string& query, int maxDist, vector<int>& ids, LookupContext& context) const;
+
+    int getMaxDist() const { return maxDist; }
+    size_t size() const { return wordCount; }
+    size_t keyCount() const;
+    size_t memoryBytes() const;
+};
+
+#endif // SYMSPELL_H
@@ -7,6 +7,8 @@
 #include <map>
 #include <algorithm>
 #include <numeric>
+#include <array>
+#include "edit_cost.h"
 
 using namespace std;
 
@@ -14,8 +16,9 @@ struct TrieNode {
     map<char, TrieNode*> children;
     bool isEndOfWord;
     string word;
+    int wordId;         // caller-assigned id of the word ending here, -1 if none
 
-    TrieNode() : isEndOfWord(false) {}
+    TrieNode() : isEndOfWord(false), wordId(-1) {}
 };
 
 class Trie {
@@ -24,17 +27,35 @@ private:
 
     void clear(TrieNode* node);
     bool remove(TrieNode* curr, const string& word, int depth);
-    void searchRecursive(TrieNode* node, char letter, const string& target, 
-                         const vector<int>& prevRow, vector<string>& results, int maxDist);
+    template<typename Cost>
+    void searchRecursive(TrieNode* node, char letter, char prevLetter, const string& target, 
+                         const vector<int>& prevRow, const vector<int>* prevPrevRow,
+                         vector<string>& results, int maxCost, size_t* rowsVisited);
+    template<int K>
+    void searchBanded(TrieNode* node, char letter, int depth, const string& target,
+                      const array<int, 2 * K + 1>& prevBand, vector<string>& results);
 
 public:
     Trie();
     ~Trie();
 
-    void insert(const string& word);
+    void insert(const string& word, int wordId = -1);
     bool contains(const string& word);
+    int getWordId(const string& word);   // -1 if the word is absent
     void remove(const string& key);
-    vector<string> getSimilarWords(const string& word, int maxDist);
+    
+    // Words within maxDist edits. The cost policy is a template argument
+    // (see edit_cost.h); only UnitCost and KeyboardCost are instantiated.
+    // rowsVisited, if given, accumulates the number of DP rows computed
+    template<typename Cost = UnitCost>
+    vector<string> getSimilarWords(const string& word, int maxDist, size_t* rowsVisited = nullptr);
+    
+    // Unit-cost search specialized for maxDist == K (instantiated for 1, 2, 3).
+    // Only the 2K+1 DP cells around the diagonal can stay within K edits, so
+    // each row is a fixed-size band and the loops unroll at compile time.
+    // Returns the same words, in the same order, as getSimilarWords(word, K)
+    template<int K>
+    vector<string> getSimilarWordsBanded(const string& word);
     
     // Accessor for A* search
     TrieNode* getRoot() const { return root; }
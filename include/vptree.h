@@ -0,0 +1,58 @@
+#ifndef VPTREE_H
+#define VPTREE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "word_embedding.h"
+
+using namespace std;
+
+// Vantage-point tree over word embeddings (Euclidean distance).
+// Each node picks a vantage point and splits the rest of its subtree at
+// the median distance to it: closer points go inside, the others outside.
+// A query at distance d from the vantage point, whose k-th best distance
+// is tau, can skip the inside when d - tau > radius and the outside when
+// d + tau < radius. The pruning only needs the triangle inequality, so it
+// applies at 32-64 dimensions, where a kd-tree's axis splits see one
+// coordinate at a time. Distances between unit vectors concentrate at
+// those sizes, though, and exact queries still visit most of the tree:
+// bound them with maxChecks for a fixed latency.
+class VPTree {
+private:
+    struct Node {
+        int point;       // word id of the vantage point
+        float radius;    // median distance from it to the rest of the subtree
+        int inside;      // node index, -1 if none
+        int outside;
+    };
+
+    HashedBigramEmbedding embedding;
+    vector<float> vectors;   // dimensions floats per word id
+    vector<Node> nodes;      // nodes[0] is the root
+    vector<string> words;    // word per id
+
+    float distance(const float* a, const float* b) const;
+    int buildRecursive(vector<int>& ids, size_t begin, size_t end, vector<float>& scratch);
+
+public:
+    explicit VPTree(int dimensions = HashedBigramEmbedding::DEFAULT_DIMENSIONS);
+
+    // Replace the tree with one over words (ids are positions in the vector)
+    void build(const vector<string>& words);
+    void clear();
+
+    // The k nearest words as (embedding distance, word), closest first.
+    // Subtrees are searched best-first by their distance bound; maxChecks
+    // caps the distances computed (0 = exact search). visited, when given,
+    // receives the number computed
+    vector<pair<double, string>> findKNearest(const string& target_word, size_t k, size_t maxChecks = 0,
+                                              size_t* visited = nullptr) const;
+
+    int getDimensions() const { return embedding.getDimensions(); }
+    size_t size() const { return words.size(); }
+    // Bytes in the vectors and nodes, not counting the word strings
+    size_t memoryBytes() const;
+};
+
+#endif // VPTREE_H
@@ -0,0 +1,31 @@
+#ifndef WORD_EMBEDDING_H
+#define WORD_EMBEDDING_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Feature hashing of character bigrams. The word is padded with boundary
+// marks ("^cat$" gives ^c, ca, at, t$), each bigram is hashed to one of
+// `dimensions` buckets with a +-1 sign, and the vector is scaled to unit
+// length. Words sharing most bigrams land close together, and a typo moves
+// only the two or three bigrams around it, unlike Position::fromWord's five
+// word-wide ratios, which many unrelated words share.
+class HashedBigramEmbedding {
+private:
+    int dimensions;
+
+public:
+    static const int DEFAULT_DIMENSIONS = 48;
+
+    explicit HashedBigramEmbedding(int dims = DEFAULT_DIMENSIONS);
+
+    int getDimensions() const { return dimensions; }
+
+    // Writes dimensions floats to out
+    void embed(const string& word, float* out) const;
+    vector<float> embed(const string& word) const;
+};
+
+#endif // WORD_EMBEDDING_H
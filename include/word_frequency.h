@@ -0,0 +1,35 @@
+#ifndef WORD_FREQUENCY_H
+#define WORD_FREQUENCY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Corpus frequency per word id, one byte each. Counts are stored on a log
+// scale, level = round(8 * log2(count + 1)), so the 0..255 range covers
+// counts up to 2^32 and words with similar counts compare equal. Words
+// without a count have level 0.
+class FrequencyStore {
+private:
+    vector<uint8_t> levels;
+
+public:
+    static uint8_t quantize(uint64_t count);
+
+    void setCount(int id, uint64_t count);
+    uint8_t level(int id) const {
+        return (id >= 0 && id < static_cast<int>(levels.size())) ? levels[id] : 0;
+    }
+
+    void clear() { levels.clear(); }
+    bool empty() const { return levels.empty(); }
+    size_t memoryBytes() const { return levels.capacity(); }
+};
+
+// Count the words of a text corpus (lowercased letters only, as the
+// spell checker cleans them) and write "word count" lines, most frequent first
+bool countCorpusWords(const string& corpusFile, const string& outputFile);
+
+#endif // WORD_FREQUENCY_H
@@ -0,0 +1,50 @@
+#ifndef WORD_SIGNATURE_H
+#define WORD_SIGNATURE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Cheap lower bounds on edit distance.
+// Every letter present in one word but not in the other needs at least one
+// edit, and every edit changes the length by at most one, so a dictionary
+// word can be rejected before any DP when
+//   |len(a) - len(b)| > maxDist, or
+//   popcount(mask(a) & ~mask(b)) > maxDist, or popcount(mask(b) & ~mask(a)) > maxDist
+// where mask() is the 26-bit set of letters a word contains.
+struct WordSignature {
+    uint32_t mask;      // bit c - 'a' set when letter c occurs
+    uint8_t length;     // clamped to 255, which keeps the length bound valid
+    uint8_t popcount;   // number of distinct letters
+
+    static WordSignature of(const string& word);
+};
+
+// Signatures of all dictionary words, stored column by column so a full
+// scan compares 32 lengths/popcounts and 8 masks per AVX2 instruction
+class SignatureTable {
+private:
+    vector<string> words;
+    vector<uint32_t> masks;
+    vector<uint8_t> lengths;
+    vector<uint8_t> popcounts;
+
+public:
+    // Appends a word and returns its id (ids are dense, in insertion order)
+    int add(const string& word);
+    void clear();
+
+    size_t size() const { return words.size(); }
+    const string& word(int id) const { return words[id]; }
+    const vector<string>& getWords() const { return words; }
+
+    // True unless the signatures prove the word is more than maxDist edits away
+    bool mayMatch(int id, const WordSignature& target, int maxDist) const;
+
+    // Ids of every word that passes the filter, in id order
+    void scan(const string& target, int maxDist, vector<int>& ids) const;
+};
+
+#endif // WORD_SIGNATURE_H
@@ -1,105 +1,163 @@
 #include "../include/astar_spellcheck.h"
-#include <omp.h>
 
-AStarSpellChecker::AStarSpellChecker(Trie* t) : trie(t) {}
+// NodeStateSet
 
-int AStarSpellChecker::heuristic(const string& current, int targetIndex, const string& target) {
-    // Admissible heuristic: minimum possible remaining edit distance
-    // At minimum, we need |remaining target chars - remaining word length| edits
-    int remainingTarget = target.length() - targetIndex;
-    int currentLen = current.length();
-    
-    // If we're building a word and have reached a valid word, 
-    // the heuristic is the remaining characters we haven't matched
-    return abs(remainingTarget - 0); 
+NodeStateSet::NodeStateSet(size_t initialCapacity) : epoch(1), count(0) {
+    size_t capacity = 16;
+    while (capacity < initialCapacity) capacity <<= 1;
+    slots.assign(capacity, Slot{nullptr, 0, 0, 0});
 }
 
-int AStarSpellChecker::levenshteinDistance(const string& s1, const string& s2) {
-    int m = s1.length();
-    int n = s2.length();
-
-    if (m == 0) return n;
-    if (n == 0) return m;
-
-    vector<vector<int>> dp(m + 1, vector<int>(n + 1));
+size_t NodeStateSet::hashOf(const TrieNode* node, int targetIndex) {
+    uint64_t h = reinterpret_cast<uintptr_t>(node) ^ (static_cast<uint64_t>(targetIndex) << 48);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
 
-    for (int i = 0; i <= m; i++) dp[i][0] = i;
-    for (int j = 0; j <= n; j++) dp[0][j] = j;
+void NodeStateSet::reset() {
+    count = 0;
+    if (++epoch == 0) {
+        // Epoch wrapped around: stale slots could look live again
+        for (auto& slot : slots) slot.epoch = 0;
+        epoch = 1;
+    }
+}
 
-    for (int k = 2; k <= m + n; k++) {
-        int start_i = max(1, k - n);
-        int end_i = min(m, k - 1);
+void NodeStateSet::grow() {
+    vector<Slot> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, Slot{nullptr, 0, 0, 0});
+    count = 0;
+    for (const auto& slot : old) {
+        if (slot.epoch == epoch) {
+            insert(slot.node, slot.targetIndex, slot.cost);
+        }
+    }
+}
 
-        #pragma omp parallel for
-        for (int i = start_i; i <= end_i; i++) {
-            int j = k - i;
-            
-            if (s1[i - 1] == s2[j - 1]) {
-                dp[i][j] = dp[i - 1][j - 1];
-            } else {
-                dp[i][j] = 1 + min({dp[i - 1][j], dp[i][j - 1], dp[i - 1][j - 1]});
-            }
+bool NodeStateSet::insert(const TrieNode* node, int targetIndex, int cost) {
+    // Keep the load factor at or below one half
+    if ((count + 1) * 2 > slots.size()) {
+        grow();
+    }
+    
+    size_t mask = slots.size() - 1;
+    size_t i = hashOf(node, targetIndex) & mask;
+    while (slots[i].epoch == epoch) {
+        if (slots[i].node == node && slots[i].targetIndex == targetIndex) {
+            if (cost >= slots[i].cost) return false;
+            slots[i].cost = cost;
+            return true;
         }
+        i = (i + 1) & mask;
     }
+    
+    slots[i] = Slot{node, targetIndex, cost, epoch};
+    count++;
+    return true;
+}
+
+// SearchContext
 
-    return dp[m][n];
+SearchContext::SearchContext() : visited(4096), resultSet(64) {
+    frontier.reserve(4096);
+    results.reserve(64);
 }
 
-vector<pair<int, string>> AStarSpellChecker::findSimilarWords(const string& target, int maxDist) {
-    vector<pair<int, string>> results;
+// AStarSpellChecker
+
+AStarSpellChecker::AStarSpellChecker(Trie* t) : trie(t), signatures(nullptr), frequencies(nullptr), stopLevel(0) {}
+
+template<typename Cost>
+int AStarSpellChecker::heuristic(int targetIndex, const string& target) {
+    // Unmatched target characters. Each costs at most one edit, so this is
+    // an upper bound on the remaining distance, not a lower bound: it is
+    // not admissible (a dictionary word ending here costs nothing more) and
+    // not consistent (a match lowers it by one at no cost). It only orders
+    // the frontier, deepest target position first among equal g-costs.
+    // Every state within the budget is still expanded, which is why the
+    // closed set re-opens a state reached again on a cheaper path.
+    // Scaled like g, so both are in the policy's cost units
+    return Cost::scale * (static_cast<int>(target.length()) - targetIndex);
+}
+
+void AStarSpellChecker::verifyCandidates(const string& target, int budget, SearchContext& context) {
+    // Drop candidates whose letter signature already exceeds the budget
+    if (signatures) {
+        WordSignature targetSignature = WordSignature::of(target);
+        auto rejected = [&](const TrieNode* node) {
+            return node->wordId >= 0 && !signatures->mayMatch(node->wordId, targetSignature, budget);
+        };
+        context.candidates.erase(remove_if(context.candidates.begin(), context.candidates.end(), rejected),
+                                 context.candidates.end());
+    }
     
-    if (!trie || !trie->getRoot()) {
-        return results;
+    // One candidate per SIMD lane; lanes beyond the budget stop the batch early
+    context.candidateWords.clear();
+    for (const TrieNode* node : context.candidates) {
+        context.candidateWords.push_back(&node->word);
     }
+    batchLevenshtein(target, context.candidateWords, context.candidateDistances, context.verification, budget);
     
-    // Priority queue: min-heap based on f-cost
-    priority_queue<AStarState, vector<AStarState>, greater<AStarState>> openSet;
+    for (size_t i = 0; i < context.candidates.size(); i++) {
+        if (context.candidateDistances[i] <= budget) {
+            context.results.push_back({context.candidateDistances[i], context.candidates[i]});
+        }
+    }
+}
+
+template<typename Cost>
+void AStarSpellChecker::searchWithBudget(const string& target, int budget, SearchContext& context) {
+    vector<AStarState>& openSet = context.frontier;
+    openSet.clear();
+    context.visited.reset();
+    context.resultSet.reset();
+    context.results.clear();
+    context.candidates.clear();
     
-    // Track visited states to avoid cycles
-    unordered_set<string> visited;
+    // Min-heap based on f-cost, kept in a plain vector so its storage survives clear()
+    greater<AStarState> heapOrder;
+    int targetLength = target.length();
     
     // Initialize with root node
     AStarState initial;
     initial.node = trie->getRoot();
-    initial.currentWord = "";
     initial.targetIndex = 0;
     initial.gCost = 0;
-    initial.fCost = heuristic("", 0, target);
+    initial.fCost = heuristic<Cost>(0, target);
     
-    openSet.push(initial);
+    openSet.push_back(initial);
     
     while (!openSet.empty()) {
-        AStarState current = openSet.top();
-        openSet.pop();
-        
-        // Create state key for visited check
-        string stateKey = to_string(reinterpret_cast<uintptr_t>(current.node)) + "_" + to_string(current.targetIndex);
+        pop_heap(openSet.begin(), openSet.end(), heapOrder);
+        AStarState current = openSet.back();
+        openSet.pop_back();
         
-        if (visited.count(stateKey)) {
+        // The heuristic counts unmatched target characters, which a run of
+        // matches can lower by more than it costs, so it is not consistent:
+        // a state may first be popped on a costlier path. Expand it again
+        // whenever a cheaper path arrives
+        if (!context.visited.insert(current.node, current.targetIndex, current.gCost)) {
             continue;
         }
-        visited.insert(stateKey);
         
-        // Pruning: if g-cost already exceeds maxDist, skip
-        if (current.gCost > maxDist) {
+        // Pruning: if g-cost already exceeds the budget, skip
+        if (current.gCost > budget) {
             continue;
         }
         
-        // Check if current node is end of a valid word
-        if (current.node->isEndOfWord) {
-            // Calculate actual edit distance to verify
-            int actualDist = levenshteinDistance(current.node->word, target);
-            if (actualDist <= maxDist) {
-                // Check if we already have this word
-                bool found = false;
-                for (const auto& [dist, word] : results) {
-                    if (word == current.node->word) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
-                    results.push_back({actualDist, current.node->word});
+        // Check if current node is end of a valid word we have not reported yet
+        if (current.node->isEndOfWord && context.resultSet.insert(current.node, -1)) {
+            // Calculate actual edit distance to verify; unit costs are
+            // verified together once the search is done
+            if constexpr (is_same<Cost, UnitCost>::value) {
+                context.candidates.push_back(current.node);
+            } else {
+                int actualDist = weightedEditDistance<Cost>(current.node->word, target);
+                if (actualDist <= budget) {
+                    context.results.push_back({actualDist, current.node});
                 }
             }
         }
@@ -108,56 +166,164 @@ vector<pair<int, string>> AStarSpellChecker::findSimilarWords(const string& targ
         for (const auto& [childChar, childNode] : current.node->children) {
             AStarState next;
             next.node = childNode;
-            next.currentWord = current.currentWord + childChar;
             
             // Calculate cost based on Levenshtein operations
             int newGCost = current.gCost;
             
-            if (current.targetIndex < target.length()) {
-                if (childChar == target[current.targetIndex]) {
-                    // Match: no additional cost
-                    next.targetIndex = current.targetIndex + 1;
-                } else {
-                    // Substitution: cost 1
-                    next.targetIndex = current.targetIndex + 1;
-                    newGCost += 1;
-                }
+            if (current.targetIndex < targetLength) {
+                // Match or substitution, priced by the cost policy
+                next.targetIndex = current.targetIndex + 1;
+                newGCost += Cost::substituteCost(childChar, target[current.targetIndex]);
             } else {
-                // Insertion in dictionary word (target exhausted): cost 1
+                // Insertion in dictionary word (target exhausted)
                 next.targetIndex = current.targetIndex;
-                newGCost += 1;
+                newGCost += Cost::insertCost(childChar);
             }
             
             next.gCost = newGCost;
-            next.fCost = newGCost + heuristic(next.currentWord, next.targetIndex, target);
+            next.fCost = newGCost + heuristic<Cost>(next.targetIndex, target);
             
             // Only add if within bounds
-            if (next.gCost <= maxDist) {
-                openSet.push(next);
+            if (next.gCost <= budget) {
+                openSet.push_back(next);
+                push_heap(openSet.begin(), openSet.end(), heapOrder);
+            }
+            
+            // Insertion in dictionary word before the target is exhausted.
+            // Without it a mid-word insertion is only reachable as a substitution
+            // plus a trailing insertion, which a tight budget would prune
+            if (current.targetIndex < targetLength && current.gCost + Cost::insertCost(childChar) <= budget) {
+                AStarState insertState = next;
+                insertState.targetIndex = current.targetIndex;
+                insertState.gCost = current.gCost + Cost::insertCost(childChar);
+                insertState.fCost = insertState.gCost + heuristic<Cost>(insertState.targetIndex, target);
+                openSet.push_back(insertState);
+                push_heap(openSet.begin(), openSet.end(), heapOrder);
+            }
+            
+            // Transposition: this child and its own child hold the next two
+            // target characters in swapped order
+            if constexpr (Cost::hasTransposition) {
+                int ti = current.targetIndex;
+                if (ti + 1 < targetLength && childChar == target[ti + 1] && childChar != target[ti] &&
+                    current.gCost + Cost::transposeCost() <= budget) {
+                    auto swapped = childNode->children.find(target[ti]);
+                    if (swapped != childNode->children.end()) {
+                        AStarState swapState;
+                        swapState.node = swapped->second;
+                        swapState.targetIndex = ti + 2;
+                        swapState.gCost = current.gCost + Cost::transposeCost();
+                        swapState.fCost = swapState.gCost + heuristic<Cost>(swapState.targetIndex, target);
+                        openSet.push_back(swapState);
+                        push_heap(openSet.begin(), openSet.end(), heapOrder);
+                    }
+                }
             }
         }
         
         // Handle deletion from target (skip a character in target)
-        if (current.targetIndex < target.length()) {
+        if (current.targetIndex < targetLength) {
             AStarState deleteState;
             deleteState.node = current.node;
-            deleteState.currentWord = current.currentWord;
             deleteState.targetIndex = current.targetIndex + 1;
-            deleteState.gCost = current.gCost + 1;  // Deletion cost
-            deleteState.fCost = deleteState.gCost + heuristic(deleteState.currentWord, deleteState.targetIndex, target);
+            deleteState.gCost = current.gCost + Cost::deleteCost(target[current.targetIndex]);
+            deleteState.fCost = deleteState.gCost + heuristic<Cost>(deleteState.targetIndex, target);
             
-            if (deleteState.gCost <= maxDist) {
-                openSet.push(deleteState);
+            if (deleteState.gCost <= budget) {
+                openSet.push_back(deleteState);
+                push_heap(openSet.begin(), openSet.end(), heapOrder);
             }
         }
     }
     
-    // Sort results by edit distance
-    sort(results.begin(), results.end());
+    if constexpr (is_same<Cost, UnitCost>::value) {
+        verifyCandidates(target, budget, context);
+    }
     
+    // Sort results by edit distance, then the more frequent word, then alphabetically
+    sort(context.results.begin(), context.results.end(),
+         [this](const pair<int, const TrieNode*>& a, const pair<int, const TrieNode*>& b) {
+             if (a.first != b.first) return a.first < b.first;
+             uint8_t levelA = levelOf(a.second), levelB = levelOf(b.second);
+             if (levelA != levelB) return levelA > levelB;
+             return a.second->word < b.second->word;
+         });
+}
+
+vector<pair<int, string>> AStarSpellChecker::toWordPairs(const SearchContext& context) {
+    vector<pair<int, string>> results;
+    results.reserve(context.results.size());
+    for (const auto& [dist, node] : context.results) {
+        results.push_back({dist, node->word});
+    }
     return results;
 }
 
+template<typename Cost>
+const vector<pair<int, const TrieNode*>>& AStarSpellChecker::findSimilarWords(const string& target, int maxDist,
+                                                                            SearchContext& context) {
+    if (!trie || !trie->getRoot()) {
+        context.results.clear();
+        return context.results;
+    }
+    
+    searchWithBudget<Cost>(target, maxDist * Cost::scale, context);
+    return context.results;
+}
+
+vector<pair<int, string>> AStarSpellChecker::findSimilarWords(const string& target, int maxDist) {
+    SearchContext context;
+    findSimilarWords(target, maxDist, context);
+    return toWordPairs(context);
+}
+
+template<typename Cost>
+const vector<pair<int, const TrieNode*>>& AStarSpellChecker::findSimilarWordsIterative(const string& target, int maxDist,
+                                                                                     size_t maxResults,
+                                                                                     SearchContext& context) {
+    context.results.clear();
+    
+    if (!trie || !trie->getRoot()) {
+        return context.results;
+    }
+    
+    // Every deepening iteration reuses the same context
+    for (int budget = 0; budget <= maxDist * Cost::scale; budget++) {
+        searchWithBudget<Cost>(target, budget, context);
+        
+        // Every word within this budget has been found, and anything found by a
+        // larger budget is strictly farther away, so the top results are final
+        if (context.results.size() >= maxResults) {
+            context.results.resize(maxResults);
+            break;
+        }
+        
+        // A common word this close is taken as the intended one
+        if (stopLevel > 0 && any_of(context.results.begin(), context.results.end(),
+                                    [this](const pair<int, const TrieNode*>& r) { return levelOf(r.second) >= stopLevel; })) {
+            break;
+        }
+    }
+    
+    return context.results;
+}
+
+template const vector<pair<int, const TrieNode*>>& AStarSpellChecker::findSimilarWords<UnitCost>(
+    const string& target, int maxDist, SearchContext& context);
+template const vector<pair<int, const TrieNode*>>& AStarSpellChecker::findSimilarWords<KeyboardCost>(
+    const string& target, int maxDist, SearchContext& context);
+template const vector<pair<int, const TrieNode*>>& AStarSpellChecker::findSimilarWordsIterative<UnitCost>(
+    const string& target, int maxDist, size_t maxResults, SearchContext& context);
+template const vector<pair<int, const TrieNode*>>& AStarSpellChecker::findSimilarWordsIterative<KeyboardCost>(
+    const string& target, int maxDist, size_t maxResults, SearchContext& context);
+
+vector<pair<int, string>> AStarSpellChecker::findSimilarWordsIterative(const string& target, int maxDist,
+                                                                      size_t maxResults) {
+    SearchContext context;
+    findSimilarWordsIterative(target, maxDist, maxResults, context);
+    return toWordPairs(context);
+}
+
 string AStarSpellChecker::findBestMatch(const string& target, int maxDist) {
     vector<pair<int, string>> similar = findSimilarWords(target, maxDist);
     
@@ -1,5 +1,10 @@
 #include "../include/benchmark.h"
 #include <cfloat>
+#include <random>
+#include <map>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // Constructor
 
@@ -34,6 +39,24 @@ double Benchmark::calculateStdDev(const vector<double>& values, double mean) {
     return sqrt(sumSq / (values.size() - 1));
 }
 
+vector<pair<string, string>> Benchmark::loadMisspellings(const string& filename) {
+    vector<pair<string, string>> pairs;
+    ifstream file(filename);
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t comma = line.find(',');
+        if (line.empty() || line[0] == '#' || comma == string::npos) continue;
+        
+        string typo = line.substr(0, comma);
+        string intended = line.substr(comma + 1);
+        if (typo != intended && checker->isValidWord(intended)) {
+            pairs.push_back({typo, intended});
+        }
+    }
+    return pairs;
+}
+
 // Benchmark methods
 
 void Benchmark::runAllBenchmarks() {
@@ -50,6 +73,24 @@ void Benchmark::runAllBenchmarks() {
     };
     benchmarkMethodComparison(testWords);
     
+    benchmarkLevenshteinKernels();
+    benchmarkSpecializedDistances(testWords);
+    benchmarkDistanceComputations(testWords);
+    benchmarkLongWords();
+    benchmarkPhoneticRecall();
+    benchmarkCascade();
+    benchmarkLengthPartitions();
+    benchmarkKDTreeBuild();
+    benchmarkFlatKDTree();
+    benchmarkKDTreeNeighbours();
+    benchmarkKDTreeLeafSizes();
+    benchmarkKDTreeBatch();
+    benchmarkKDTreeInsert();
+    benchmarkPositionFeatures();
+    benchmarkKDTreeApprox();
+    benchmarkKDTreeRerank();
+    benchmarkBigramIndex();
+    
     printSummary();
 }
 
@@ -139,6 +180,29 @@ void Benchmark::benchmarkScalability(const vector<int>& dictionarySizes) {
 void Benchmark::benchmarkMethodComparison(const vector<string>& testWords) {
     cout << "Running method comparison benchmark...\n";
     
+    // SymSpell trades build time and memory for lookup speed, so report both.
+    // The checker's own index is built here too, outside the timed lookups
+    const SignatureTable& dictionary = checker->getSignatureTable();
+    int maxDist = checker->getSymSpellIndex().getMaxDist();
+    SymSpellIndex index;
+    auto buildStart = chrono::high_resolution_clock::now();
+    index.build(dictionary.getWords(), maxDist);
+    auto buildEnd = chrono::high_resolution_clock::now();
+    double buildMs = chrono::duration<double, milli>(buildEnd - buildStart).count();
+    
+    cout << "  SymSpell index: " << dictionary.size() << " words, " << index.keyCount() << " keys, "
+         << fixed << setprecision(2) << index.memoryBytes() / (1024.0 * 1024.0) << " MB, built in "
+         << setprecision(1) << buildMs << " ms\n";
+    
+    BenchmarkResult build;
+    build.methodName = "symspell";
+    build.testName = "index_build";
+    build.inputSize = dictionary.size();
+    build.iterations = 1;
+    build.avgTimeMs = build.minTimeMs = build.maxTimeMs = buildMs;
+    build.throughput = dictionary.size() * 1000.0 / max(buildMs, 1e-9);  // words indexed per second
+    results.push_back(build);
+    
     for (const string& word : testWords) {
         MethodComparison comp;
         comp.word = word;
@@ -161,8 +225,1013 @@ void Benchmark::benchmarkMethodComparison(const vector<string>& testWords) {
         end = chrono::high_resolution_clock::now();
         comp.astarTimeMs = chrono::duration<double, milli>(end - start).count();
         
+        // SymSpell
+        start = chrono::high_resolution_clock::now();
+        comp.symspellSuggestions = checker->getSuggestionsSymSpell(word);
+        end = chrono::high_resolution_clock::now();
+        comp.symspellTimeMs = chrono::duration<double, milli>(end - start).count();
+        
         comparisons.push_back(comp);
     }
+    
+    double totals[4] = {0, 0, 0, 0};
+    for (const auto& c : comparisons) {
+        totals[0] += c.trieTimeMs;
+        totals[1] += c.kdtreeTimeMs;
+        totals[2] += c.astarTimeMs;
+        totals[3] += c.symspellTimeMs;
+    }
+    if (!comparisons.empty()) {
+        cout << "  Avg lookup (ms): trie=" << setprecision(4) << totals[0] / comparisons.size()
+             << " kdtree=" << totals[1] / comparisons.size()
+             << " astar=" << totals[2] / comparisons.size()
+             << " symspell=" << totals[3] / comparisons.size() << "\n";
+    }
+}
+
+void Benchmark::benchmarkLevenshteinKernels(int iterations) {
+    cout << "Running Levenshtein kernel microbenchmark (active kernel: "
+         << levenshteinKernelName(activeLevenshteinKernel()) << ")...\n";
+    
+    // Pairs of random lowercase strings; the second one is a mutated copy so
+    // the distance stays realistic (roughly a quarter of the length)
+    mt19937 rng(42);
+    uniform_int_distribution<int> letter('a', 'z');
+    
+    vector<LevenshteinKernel> kernels = {LevenshteinKernel::Scalar, LevenshteinKernel::SSE41,
+                                         LevenshteinKernel::AVX2};
+    LevenshteinScratch scratch;
+    
+    cout << "  Length";
+    for (LevenshteinKernel kernel : kernels) {
+        cout << setw(12) << levenshteinKernelName(kernel);
+    }
+    cout << "   (ns per call)\n";
+    
+    for (int length : {4, 8, 16, 32, 64, 128, 256}) {
+        string a(length, 'a');
+        for (char& c : a) c = letter(rng);
+        string b = a;
+        for (int i = 0; i < length / 4 + 1; i++) {
+            b[rng() % length] = letter(rng);
+        }
+        
+        cout << "  " << setw(6) << length;
+        for (LevenshteinKernel kernel : kernels) {
+            if (!levenshteinKernelSupported(kernel)) {
+                cout << setw(12) << "n/a";
+                continue;
+            }
+            
+            int calls = max(50, iterations * 16 / length);
+            volatile int sink = 0;
+            vector<double> times;
+            for (int rep = 0; rep < 5; rep++) {
+                auto start = chrono::high_resolution_clock::now();
+                for (int i = 0; i < calls; i++) {
+                    sink = sink + levenshteinWithKernel(kernel, a, b, scratch);
+                }
+                auto end = chrono::high_resolution_clock::now();
+                times.push_back(chrono::duration<double, milli>(end - start).count() / calls);
+            }
+            
+            BenchmarkResult result;
+            result.methodName = string("levenshtein_") + levenshteinKernelName(kernel);
+            result.testName = "levenshtein_len_" + to_string(length);
+            result.inputSize = length;
+            result.iterations = calls;
+            result.avgTimeMs = calculateMean(times);
+            result.stdDevMs = calculateStdDev(times, result.avgTimeMs);
+            result.minTimeMs = *min_element(times.begin(), times.end());
+            result.maxTimeMs = *max_element(times.begin(), times.end());
+            result.throughput = 1000.0 / result.avgTimeMs;  // distance computations per second
+            results.push_back(result);
+            
+            cout << setw(12) << fixed << setprecision(1) << result.minTimeMs * 1e6;
+        }
+        cout << "\n";
+    }
+}
+
+void Benchmark::benchmarkSpecializedDistances(const vector<string>& testWords, int iterations) {
+    cout << "Running maxDist-specialized trie search benchmark...\n";
+    
+    Trie* trie = checker->getTriePtr();
+    
+    // Time one pass over all test words, best of several repetitions
+    auto timeSearch = [&](auto&& search) {
+        vector<double> times;
+        size_t found = 0;
+        for (int rep = 0; rep < iterations; rep++) {
+            auto start = chrono::high_resolution_clock::now();
+            for (const string& word : testWords) {
+                found += search(word).size();
+            }
+            auto end = chrono::high_resolution_clock::now();
+            times.push_back(chrono::duration<double, milli>(end - start).count() / testWords.size());
+        }
+        return make_pair(times, found);
+    };
+    
+    auto record = [&](const string& method, int k, const vector<double>& times) {
+        BenchmarkResult result;
+        result.methodName = method;
+        result.testName = "trie_maxdist_" + to_string(k);
+        result.inputSize = testWords.size();
+        result.iterations = iterations;
+        result.avgTimeMs = calculateMean(times);
+        result.stdDevMs = calculateStdDev(times, result.avgTimeMs);
+        result.minTimeMs = *min_element(times.begin(), times.end());
+        result.maxTimeMs = *max_element(times.begin(), times.end());
+        result.throughput = 1000.0 / result.avgTimeMs;  // queries per second
+        results.push_back(result);
+        return result.minTimeMs;
+    };
+    
+    cout << "  maxDist     generic(ms)    banded(ms)   speedup\n";
+    for (int k = 1; k <= 3; k++) {
+        auto generic = timeSearch([&](const string& w) { return trie->getSimilarWords<UnitCost>(w, k); });
+        auto banded = timeSearch([&](const string& w) {
+            if (k == 1) return trie->getSimilarWordsBanded<1>(w);
+            if (k == 2) return trie->getSimilarWordsBanded<2>(w);
+            return trie->getSimilarWordsBanded<3>(w);
+        });
+        
+        double genericMs = record("trie_generic", k, generic.first);
+        double bandedMs = record("trie_banded_k" + to_string(k), k, banded.first);
+        
+        cout << "  " << setw(7) << k << setw(16) << fixed << setprecision(4) << genericMs
+             << setw(14) << bandedMs << setw(9) << setprecision(2) << genericMs / bandedMs << "x"
+             << (generic.second == banded.second ? "" : "  (result mismatch!)") << "\n";
+    }
+}
+
+void Benchmark::benchmarkDistanceComputations(const vector<string>& testWords) {
+    cout << "Running BK-tree vs trie scaling benchmark (work per query at maxDist 2)...\n";
+    
+    const vector<string>& dictionary = checker->getSignatureTable().getWords();
+    if (dictionary.empty() || testWords.empty()) return;
+    
+    vector<size_t> sizes;
+    for (size_t n = 1000; n < dictionary.size(); n *= 2) sizes.push_back(n);
+    sizes.push_back(dictionary.size());
+    
+    cout << "  Words   BK dist/query  (% of dict)  BK ms/query  Trie rows/query  Trie ms/query\n";
+    for (size_t n : sizes) {
+        // Both structures over the first n dictionary words
+        BKTree bk;
+        Trie trie;
+        for (size_t i = 0; i < n; i++) {
+            bk.insert(dictionary[i]);
+            trie.insert(dictionary[i]);
+        }
+        
+        size_t distances = 0, rows = 0;
+        vector<pair<int, string>> found;
+        auto start = chrono::high_resolution_clock::now();
+        for (const string& word : testWords) {
+            bk.search(word, 2, found, &distances);
+        }
+        auto mid = chrono::high_resolution_clock::now();
+        for (const string& word : testWords) {
+            trie.getSimilarWords(word, 2, &rows);
+        }
+        auto end = chrono::high_resolution_clock::now();
+        
+        double queries = testWords.size();
+        double bkMs = chrono::duration<double, milli>(mid - start).count() / queries;
+        double trieMs = chrono::duration<double, milli>(end - mid).count() / queries;
+        
+        cout << "  " << setw(6) << n
+             << setw(15) << fixed << setprecision(1) << distances / queries
+             << setw(12) << setprecision(1) << 100.0 * distances / queries / bk.size() << "%"
+             << setw(13) << setprecision(4) << bkMs
+             << setw(17) << setprecision(1) << rows / queries
+             << setw(15) << setprecision(4) << trieMs << "\n";
+        
+        BenchmarkResult bkResult;
+        bkResult.methodName = "bktree";
+        bkResult.testName = "distance_computations_" + to_string(n);
+        bkResult.inputSize = n;
+        bkResult.iterations = testWords.size();
+        bkResult.avgTimeMs = bkResult.minTimeMs = bkResult.maxTimeMs = bkMs;
+        bkResult.throughput = distances / queries;  // distance computations per query
+        results.push_back(bkResult);
+        
+        BenchmarkResult trieResult = bkResult;
+        trieResult.methodName = "trie";
+        trieResult.testName = "dp_rows_" + to_string(n);
+        trieResult.avgTimeMs = trieResult.minTimeMs = trieResult.maxTimeMs = trieMs;
+        trieResult.throughput = rows / queries;  // DP rows per query
+        results.push_back(trieResult);
+    }
+}
+
+void Benchmark::benchmarkLongWords(int queryCount) {
+    cout << "Running long-word benchmark (dictionary words over 10 characters, 2 random edits)...\n";
+    
+    // Misspell long dictionary words with two random edits each
+    mt19937 rng(7);
+    uniform_int_distribution<int> letter('a', 'z');
+    vector<pair<string, string>> queries;  // (misspelling, intended word)
+    for (const string& word : checker->getSignatureTable().getWords()) {
+        if (word.length() <= 10) continue;
+        string typo = word;
+        for (int edit = 0; edit < 2; edit++) {
+            size_t pos = rng() % typo.length();
+            switch (rng() % 3) {
+                case 0: typo[pos] = letter(rng); break;
+                case 1: typo.erase(pos, 1); break;
+                default: typo.insert(typo.begin() + pos, static_cast<char>(letter(rng))); break;
+            }
+        }
+        queries.push_back({typo, word});
+        if (static_cast<int>(queries.size()) >= queryCount) break;
+    }
+    if (queries.empty()) {
+        cout << "  No words over 10 characters in the dictionary.\n";
+        return;
+    }
+    
+    const QGramIndex& qgrams = checker->getQGramIndex();
+    checker->getSymSpellIndex();
+    cout << "  Bigram index: " << fixed << setprecision(2) << qgrams.memoryBytes() / (1024.0 * 1024.0)
+         << " MB, " << setprecision(1) << 100.0 * qgrams.memoryBytes() / max<size_t>(qgrams.uncompressedBytes(), 1)
+         << "% of the postings as plain 32-bit ids\n";
+    
+    vector<pair<string, function<vector<string>(const string&)>>> methods = {
+        {"trie", [&](const string& w) { return checker->getSuggestionsTrie(w); }},
+        {"astar", [&](const string& w) { return checker->getSuggestionsAStar(w); }},
+        {"symspell", [&](const string& w) { return checker->getSuggestionsSymSpell(w); }},
+        {"bktree", [&](const string& w) { return checker->getSuggestionsBKTree(w); }},
+        {"qgram", [&](const string& w) { return checker->getSuggestionsQGram(w); }},
+    };
+    
+    cout << "  Method      ms/query   found intended\n";
+    for (const auto& [name, suggest] : methods) {
+        int hits = 0;
+        vector<double> times;
+        for (const auto& [typo, intended] : queries) {
+            auto start = chrono::high_resolution_clock::now();
+            vector<string> suggestions = suggest(typo);
+            auto end = chrono::high_resolution_clock::now();
+            times.push_back(chrono::duration<double, milli>(end - start).count());
+            if (find(suggestions.begin(), suggestions.end(), intended) != suggestions.end()) hits++;
+        }
+        
+        BenchmarkResult result;
+        result.methodName = name;
+        result.testName = "long_words";
+        result.inputSize = queries.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = calculateMean(times);
+        result.stdDevMs = calculateStdDev(times, result.avgTimeMs);
+        result.minTimeMs = *min_element(times.begin(), times.end());
+        result.maxTimeMs = *max_element(times.begin(), times.end());
+        result.throughput = 1000.0 / result.avgTimeMs;
+        results.push_back(result);
+        
+        cout << "  " << setw(10) << left << name << right << setw(10) << setprecision(4) << result.avgTimeMs
+             << setw(10) << hits << "/" << queries.size() << "\n";
+    }
+}
+
+void Benchmark::benchmarkPhoneticRecall(const string& misspellingsFile) {
+    cout << "Running phonetic candidate benchmark (" << misspellingsFile << ")...\n";
+    
+    vector<pair<string, string>> queries = loadMisspellings(misspellingsFile);
+    if (queries.empty()) {
+        cout << "  No misspellings with their intended word in the dictionary.\n";
+        return;
+    }
+    
+    checker->getSymSpellIndex();
+    checker->getQGramIndex();
+    const PhoneticIndex& phonetics = checker->getPhoneticIndex();
+    cout << "  Phonetic index: " << phonetics.size() << " codes, " << fixed << setprecision(1)
+         << phonetics.memoryBytes() / 1024.0 << " KB\n";
+    
+    vector<pair<string, function<vector<string>(const string&)>>> methods = {
+        {"trie", [&](const string& w) { return checker->getSuggestionsTrie(w); }},
+        {"kdtree", [&](const string& w) { return checker->getSuggestionsKDTree(w); }},
+        {"astar", [&](const string& w) { return checker->getSuggestionsAStar(w); }},
+        {"symspell", [&](const string& w) { return checker->getSuggestionsSymSpell(w); }},
+        {"qgram", [&](const string& w) { return checker->getSuggestionsQGram(w); }},
+    };
+    
+    // Recall = intended word among the suggestions; the merge is timed on
+    // its own so its cost is what the recall gain is divided by
+    cout << "  Method     recall   +phonetic   ms/query   merge ms   recall/us\n";
+    for (const auto& [name, suggest] : methods) {
+        int hits = 0, mergedHits = 0;
+        double methodMs = 0, mergeMs = 0;
+        for (const auto& [typo, intended] : queries) {
+            auto start = chrono::high_resolution_clock::now();
+            vector<string> suggestions = suggest(typo);
+            auto mid = chrono::high_resolution_clock::now();
+            bool found = find(suggestions.begin(), suggestions.end(), intended) != suggestions.end();
+            checker->mergePhoneticCandidates(typo, suggestions);
+            auto end = chrono::high_resolution_clock::now();
+            
+            methodMs += chrono::duration<double, milli>(mid - start).count();
+            mergeMs += chrono::duration<double, milli>(end - mid).count();
+            if (found) hits++;
+            if (find(suggestions.begin(), suggestions.end(), intended) != suggestions.end()) mergedHits++;
+        }
+        
+        double n = queries.size();
+        double recallGain = (mergedHits - hits) / n;
+        double mergeUs = 1000.0 * mergeMs / n;
+        
+        BenchmarkResult result;
+        result.methodName = name + "+phonetic";
+        result.testName = "phonetic_recall";
+        result.inputSize = queries.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = (methodMs + mergeMs) / n;
+        result.throughput = mergeUs > 0 ? recallGain / mergeUs : 0;  // recall gained per microsecond
+        results.push_back(result);
+        
+        cout << "  " << setw(9) << left << name << right << setw(7) << setprecision(3) << hits / n
+             << setw(12) << mergedHits / n << setw(11) << setprecision(4) << methodMs / n
+             << setw(11) << mergeMs / n << setw(12) << result.throughput << "\n";
+    }
+}
+
+void Benchmark::benchmarkCascade(const string& misspellingsFile) {
+    cout << "Running cascade benchmark (" << misspellingsFile << ")...\n";
+    
+    vector<pair<string, string>> queries = loadMisspellings(misspellingsFile);
+    if (queries.empty()) {
+        cout << "  No misspellings with their intended word in the dictionary.\n";
+        return;
+    }
+    checker->getSymSpellIndex();
+    
+    // A private engine, so the stage counters cover exactly these queries
+    CascadeEngine cascade(*checker);
+    vector<pair<string, function<vector<string>(const string&)>>> methods = {
+        {"cascade", [&](const string& w) { return cascade.suggest(w); }},
+        {"symspell", [&](const string& w) { return checker->getSuggestionsSymSpell(w); }},
+        {"astar", [&](const string& w) { return checker->getSuggestionsAStar(w); }},
+        {"kdtree", [&](const string& w) { return checker->getSuggestionsKDTree(w); }},
+    };
+    
+    cout << "  Method      ms/query   max ms   found intended\n";
+    for (const auto& [name, suggest] : methods) {
+        int hits = 0;
+        vector<double> times;
+        for (const auto& [typo, intended] : queries) {
+            auto start = chrono::high_resolution_clock::now();
+            vector<string> suggestions = suggest(typo);
+            auto end = chrono::high_resolution_clock::now();
+            times.push_back(chrono::duration<double, milli>(end - start).count());
+            if (find(suggestions.begin(), suggestions.end(), intended) != suggestions.end()) hits++;
+        }
+        
+        BenchmarkResult result;
+        result.methodName = name;
+        result.testName = "cascade_misspellings";
+        result.inputSize = queries.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = calculateMean(times);
+        result.stdDevMs = calculateStdDev(times, result.avgTimeMs);
+        result.minTimeMs = *min_element(times.begin(), times.end());
+        result.maxTimeMs = *max_element(times.begin(), times.end());
+        result.throughput = 1000.0 / result.avgTimeMs;
+        results.push_back(result);
+        
+        cout << "  " << setw(10) << left << name << right << fixed << setw(10) << setprecision(4)
+             << result.avgTimeMs << setw(9) << result.maxTimeMs << setw(10) << hits << "/" << queries.size() << "\n";
+    }
+    
+    cascade.printStats();
+}
+
+void Benchmark::benchmarkLengthPartitions(int queriesPerLength) {
+    cout << "Running length-partition benchmark (one random edit per query)...\n";
+    
+    // Misspelled dictionary words, grouped by the query's length
+    mt19937 rng(11);
+    uniform_int_distribution<int> letter('a', 'z');
+    map<size_t, vector<string>> byLength;
+    for (const string& word : checker->getSignatureTable().getWords()) {
+        string typo = word;
+        size_t pos = rng() % typo.length();
+        switch (rng() % 3) {
+            case 0: typo[pos] = letter(rng); break;
+            case 1: if (typo.length() > 2) typo.erase(pos, 1); break;
+            default: typo.insert(typo.begin() + pos, static_cast<char>(letter(rng))); break;
+        }
+        vector<string>& queries = byLength[typo.length()];
+        if (static_cast<int>(queries.size()) < queriesPerLength) queries.push_back(typo);
+    }
+    
+    bool wasPartitioned = checker->getLengthPartitioning();
+    auto averageMs = [&](const vector<string>& queries, const function<vector<string>(const string&)>& suggest) {
+        auto start = chrono::high_resolution_clock::now();
+        for (const string& q : queries) suggest(q);
+        auto end = chrono::high_resolution_clock::now();
+        return chrono::duration<double, milli>(end - start).count() / queries.size();
+    };
+    auto trie = [&](const string& w) { return checker->getSuggestionsTrie(w); };
+    auto kd = [&](const string& w) { return checker->getSuggestionsKDTree(w); };
+    
+    cout << "  Length  queries   trie ms   sharded   parallel   kdtree ms   sharded\n";
+    for (const auto& [length, queries] : byLength) {
+        if (queries.size() < 5) continue;
+        
+        checker->setLengthPartitioning(false);
+        double trieMs = averageMs(queries, trie);
+        double kdMs = averageMs(queries, kd);
+        checker->setLengthPartitioning(true, false);
+        double shardMs = averageMs(queries, trie);
+        double shardKdMs = averageMs(queries, kd);
+        checker->setLengthPartitioning(true, true);
+        double parallelMs = averageMs(queries, trie);
+        
+        for (const auto& [name, ms] : {pair<string, double>{"trie", trieMs}, {"trie_sharded", shardMs},
+                                       {"trie_sharded_parallel", parallelMs}, {"kdtree", kdMs},
+                                       {"kdtree_sharded", shardKdMs}}) {
+            BenchmarkResult result;
+            result.methodName = name;
+            result.testName = "length_" + to_string(length);
+            result.inputSize = length;
+            result.iterations = queries.size();
+            result.avgTimeMs = result.minTimeMs = result.maxTimeMs = ms;
+            result.throughput = 1000.0 / ms;
+            results.push_back(result);
+        }
+        
+        cout << "  " << setw(6) << length << setw(9) << queries.size() << fixed << setprecision(4)
+             << setw(10) << trieMs << setw(10) << shardMs << setw(11) << parallelMs
+             << setw(12) << kdMs << setw(10) << shardKdMs << "\n";
+    }
+    checker->setLengthPartitioning(wasPartitioned);
+}
+
+void Benchmark::benchmarkKDTreeBuild(int queryCount) {
+    cout << "Running kd-tree construction benchmark (insertion order vs median split)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    // Queries spread evenly over the dictionary
+    vector<string> queries;
+    size_t step = max<size_t>(1, words.size() / queryCount);
+    for (size_t i = 0; i < words.size() && static_cast<int>(queries.size()) < queryCount; i += step) {
+        queries.push_back(words[i] + "s");
+    }
+    
+    KDTree inserted, balanced;
+    double insertMs = measureTime([&]() { for (const string& w : words) inserted.insert(w); });
+    double buildMs = measureTime([&]() { balanced.build(words); });
+    
+    cout << "  Build        ms      depth   ms/query (k=5)\n";
+    for (const auto& [name, tree, ms] : {make_tuple(string("insert"), &inserted, insertMs),
+                                         make_tuple(string("median"), &balanced, buildMs)}) {
+        double queryMs = measureTime([&]() { for (const string& q : queries) tree->findKNearest(q, 5); }) / queries.size();
+        
+        BenchmarkResult result;
+        result.methodName = "kdtree_" + name;
+        result.testName = "kdtree_build";
+        result.inputSize = words.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = queryMs;
+        result.throughput = tree->depth();  // tree depth
+        results.push_back(result);
+        
+        cout << "  " << setw(8) << left << name << right << fixed << setprecision(2) << setw(10) << ms
+             << setw(10) << tree->depth() << setw(14) << setprecision(4) << queryMs << "\n";
+    }
+}
+
+void Benchmark::benchmarkFlatKDTree(int queryCount) {
+    cout << "Running kd-tree layout benchmark (pointer nodes vs implicit array)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    vector<string> queries;
+    size_t step = max<size_t>(1, words.size() / queryCount);
+    for (size_t i = 0; i < words.size() && static_cast<int>(queries.size()) < queryCount; i += step) {
+        queries.push_back(words[i] + "s");
+    }
+    
+    // Same median-split shape for both, so only the layout differs
+    KDTree pointerTree;
+    pointerTree.build(words);
+    FlatKDTree flatTree;
+    flatTree.build(words);
+    
+    size_t pointerVisited = 0, flatVisited = 0, agree = 0;
+    for (const string& q : queries) {
+        size_t visited = 0;
+        vector<Position> expected = pointerTree.findKNearest(q, 5, &visited);
+        pointerVisited += visited;
+        vector<Position> found = flatTree.findKNearest(q, 5, &visited);
+        flatVisited += visited;
+        
+        // Many words share a position, so compare neighbour distances
+        // rather than which of the tied words each tree kept
+        Position target = Position::fromWord(q);
+        bool same = expected.size() == found.size();
+        for (size_t i = 0; same && i < found.size(); i++) {
+            same = fabs(expected[i].distance(target) - found[i].distance(target)) < 1e-5;
+        }
+        if (same) agree++;
+    }
+    
+    double pointerMs = measureTime([&]() { for (const string& q : queries) pointerTree.findKNearest(q, 5); });
+    double flatMs = measureTime([&]() { for (const string& q : queries) flatTree.findKNearest(q, 5); });
+    
+    cout << "  Layout     nodes/query   ns/query (k=5)\n";
+    for (const auto& [name, visited, ms] : {make_tuple(string("pointer"), pointerVisited, pointerMs),
+                                            make_tuple(string("flat"), flatVisited, flatMs)}) {
+        double nsPerQuery = ms * 1e6 / queries.size();
+        
+        BenchmarkResult result;
+        result.methodName = "kdtree_" + name;
+        result.testName = "kdtree_layout";
+        result.inputSize = words.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = ms / queries.size();
+        result.throughput = 1000.0 * queries.size() / ms;
+        results.push_back(result);
+        
+        cout << "  " << setw(8) << left << name << right << fixed << setprecision(1)
+             << setw(14) << static_cast<double>(visited) / queries.size()
+             << setw(14) << setprecision(0) << nsPerQuery << "\n";
+    }
+    cout << "  Same neighbour distances: " << agree << "/" << queries.size()
+         << " queries (flat tree: " << flatTree.memoryBytes() / 1024 << " KB of node data)\n";
+}
+
+void Benchmark::benchmarkKDTreeNeighbours(const vector<int>& ks, int queryCount) {
+    cout << "Running kd-tree k-NN benchmark (nodes visited and latency by k)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    vector<string> queries;
+    size_t step = max<size_t>(1, words.size() / queryCount);
+    for (size_t i = 0; i < words.size() && static_cast<int>(queries.size()) < queryCount; i += step) {
+        queries.push_back(words[i] + "s");
+    }
+    
+    KDTree* tree = checker->getKDTreePtr();
+    cout << "  k       nodes/query   % of tree   ms/query\n";
+    for (int k : ks) {
+        size_t visitedTotal = 0;
+        for (const string& q : queries) {
+            size_t visited = 0;
+            tree->findKNearest(q, k, &visited);
+            visitedTotal += visited;
+        }
+        double queryMs = measureTime([&]() { for (const string& q : queries) tree->findKNearest(q, k); }) / queries.size();
+        double nodesPerQuery = static_cast<double>(visitedTotal) / queries.size();
+        
+        BenchmarkResult result;
+        result.methodName = "kdtree_k" + to_string(k);
+        result.testName = "kdtree_knn";
+        result.inputSize = words.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = queryMs;
+        result.throughput = 1000.0 / queryMs;
+        results.push_back(result);
+        
+        cout << "  " << setw(4) << left << k << right << fixed << setprecision(1)
+             << setw(14) << nodesPerQuery << setw(11) << 100.0 * nodesPerQuery / tree->size() << "%"
+             << setw(11) << setprecision(4) << queryMs << "\n";
+    }
+}
+
+void Benchmark::benchmarkKDTreeLeafSizes(const vector<int>& leafSizes, int queryCount) {
+    cout << "Running kd-tree leaf bucket benchmark (ns/query, k=5, by leaf and dictionary size)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    // An eighth, half and all of the dictionary
+    vector<size_t> sizes;
+    for (size_t divisor : {8, 2, 1}) {
+        if (words.size() / divisor > 0 && (sizes.empty() || sizes.back() != words.size() / divisor)) {
+            sizes.push_back(words.size() / divisor);
+        }
+    }
+    
+    cout << "  Leaf    ";
+    for (size_t n : sizes) cout << setw(12) << (to_string(n) + " words");
+    cout << "\n";
+    
+    // Leaf size 0 stands for the point-per-node FlatKDTree
+    vector<int> rows = {0};
+    rows.insert(rows.end(), leafSizes.begin(), leafSizes.end());
+    for (int leafSize : rows) {
+        cout << "  " << setw(8) << left << (leafSize == 0 ? string("flat") : to_string(leafSize)) << right;
+        for (size_t n : sizes) {
+            vector<string> subset(words.begin(), words.begin() + n);
+            vector<string> queries;
+            size_t step = max<size_t>(1, n / queryCount);
+            for (size_t i = 0; i < n && static_cast<int>(queries.size()) < queryCount; i += step) {
+                queries.push_back(subset[i] + "s");
+            }
+            
+            FlatKDTree flat;
+            BucketKDTree bucketed(max(leafSize, 1));
+            double queryMs;
+            if (leafSize == 0) {
+                flat.build(subset);
+                queryMs = measureTime([&]() { for (const string& q : queries) flat.findKNearest(q, 5); }) / queries.size();
+            } else {
+                bucketed.build(subset);
+                queryMs = measureTime([&]() { for (const string& q : queries) bucketed.findKNearest(q, 5); }) / queries.size();
+            }
+            
+            BenchmarkResult result;
+            result.methodName = leafSize == 0 ? "kdtree_flat" : "kdtree_leaf" + to_string(leafSize);
+            result.testName = "kdtree_leaf_size";
+            result.inputSize = n;
+            result.iterations = queries.size();
+            result.avgTimeMs = result.minTimeMs = result.maxTimeMs = queryMs;
+            result.throughput = 1000.0 / queryMs;
+            results.push_back(result);
+            
+            cout << setw(12) << fixed << setprecision(0) << queryMs * 1e6;
+        }
+        cout << "\n";
+    }
+}
+
+void Benchmark::benchmarkKDTreeBatch(int queryCount) {
+    cout << "Running batched kd-tree query benchmark (" << queryCount << " misspelled words, k=5)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    // Words in document order: random dictionary words with one substitution
+    mt19937 rng(13);
+    uniform_int_distribution<int> letter('a', 'z');
+    vector<string> queries;
+    for (int i = 0; i < queryCount; i++) {
+        string typo = words[rng() % words.size()];
+        typo[rng() % typo.length()] = static_cast<char>(letter(rng));
+        queries.push_back(typo);
+    }
+    
+    BucketKDTree tree;
+    tree.build(words);
+    int threads = 1;
+    #ifdef _OPENMP
+    threads = omp_get_max_threads();
+    #endif
+    
+    vector<vector<Position>> single(queries.size()), batched, parallel;
+    double singleMs = measureTime([&]() {
+        for (size_t i = 0; i < queries.size(); i++) single[i] = tree.findKNearest(queries[i], 5);
+    });
+    double batchMs = measureTime([&]() { batched = tree.findKNearestBatch(queries, 5); });
+    double parallelMs = measureTime([&]() { parallel = tree.findKNearestBatch(queries, 5, threads); });
+    
+    // Same neighbours as one query at a time
+    size_t agree = 0;
+    for (size_t i = 0; i < queries.size(); i++) {
+        bool same = single[i].size() == batched[i].size() && single[i].size() == parallel[i].size();
+        for (size_t j = 0; same && j < single[i].size(); j++) {
+            same = single[i][j].word == batched[i][j].word && single[i][j].word == parallel[i][j].word;
+        }
+        if (same) agree++;
+    }
+    
+    cout << "  Mode                 total ms   us/query\n";
+    for (const auto& [name, ms] : {make_pair(string("per word"), singleMs),
+                                   make_pair(string("batch"), batchMs),
+                                   make_pair("batch " + to_string(threads) + " threads", parallelMs)}) {
+        BenchmarkResult result;
+        result.methodName = "kdtree_" + name;
+        result.testName = "kdtree_batch";
+        result.inputSize = queries.size();
+        result.iterations = 1;
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = ms;
+        result.throughput = 1000.0 * queries.size() / ms;
+        results.push_back(result);
+        
+        cout << "  " << setw(18) << left << name << right << fixed << setprecision(2) << setw(11) << ms
+             << setw(11) << setprecision(2) << 1000.0 * ms / queries.size() << "\n";
+    }
+    cout << "  Same neighbours as per-word queries: " << agree << "/" << queries.size() << "\n";
+}
+
+void Benchmark::benchmarkKDTreeInsert(const vector<double>& balanceFactors, int insertsPerQuery) {
+    cout << "Running incremental kd-tree benchmark (sorted inserts, one query every "
+         << insertsPerQuery << " inserts)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    // Dictionary files are sorted, which is the worst order for the
+    // first-letter axis; each query is a typo of a word already inserted
+    vector<string> sorted = words;
+    sort(sorted.begin(), sorted.end());
+    
+    cout << "  Balance    insert ms   query ms   nodes/query   depth   rebuilds\n";
+    for (double factor : balanceFactors) {
+        KDTree tree;
+        tree.setBalanceFactor(factor);
+        double insertMs = 0.0, queryMs = 0.0;
+        size_t visitedTotal = 0, queries = 0;
+        for (size_t i = 0; i < sorted.size(); i++) {
+            insertMs += measureTime([&]() { tree.insert(sorted[i]); });
+            if ((i + 1) % insertsPerQuery == 0) {
+                string query = sorted[(i * 7919) % (i + 1)] + "s";
+                size_t visited = 0;
+                queryMs += measureTime([&]() { tree.findKNearest(query, 5, &visited); });
+                visitedTotal += visited;
+                queries++;
+            }
+        }
+        
+        string name = factor >= 1.0 ? "off" : to_string(factor).substr(0, 3);
+        BenchmarkResult result;
+        result.methodName = "kdtree_balance_" + name;
+        result.testName = "kdtree_insert";
+        result.inputSize = sorted.size();
+        result.iterations = queries;
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = (insertMs + queryMs) / sorted.size();
+        result.throughput = tree.depth();  // final depth
+        results.push_back(result);
+        
+        cout << "  " << setw(8) << left << name << right << fixed << setprecision(2) << setw(12) << insertMs
+             << setw(11) << queryMs << setw(14) << setprecision(1)
+             << static_cast<double>(visitedTotal) / max<size_t>(queries, 1)
+             << setw(8) << tree.depth() << setw(11) << tree.getRebuildCount() << "\n";
+    }
+}
+
+void Benchmark::benchmarkPositionFeatures(int rounds) {
+    cout << "Running kd-tree coordinate benchmark (" << rounds << " passes over the dictionary)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    // Results go to a volatile sink so the work is not optimised away
+    volatile float sink = 0.0f;
+    vector<float> columns[Position::DIMENSIONS];
+    float* out[Position::DIMENSIONS];
+    for (size_t d = 0; d < Position::DIMENSIONS; d++) {
+        columns[d].resize(words.size());
+        out[d] = columns[d].data();
+    }
+    
+    double positionMs = measureTime([&]() {
+        for (const string& w : words) sink = sink + Position::fromWord(w).coords[0];
+    }, rounds);
+    double arrayMs = measureTime([&]() {
+        float coords[Position::DIMENSIONS];
+        for (const string& w : words) {
+            Position::fromWord(w, coords);
+            sink = sink + coords[0];
+        }
+    }, rounds);
+    double batchMs = measureTime([&]() {
+        Position::fromWords(words, out);
+        sink = sink + columns[0][0];
+    }, rounds);
+    
+    cout << "  Version        ns/word\n";
+    for (const auto& [name, ms] : {make_pair(string("position"), positionMs), make_pair(string("array"), arrayMs),
+                                   make_pair(string("batch"), batchMs)}) {
+        BenchmarkResult result;
+        result.methodName = "fromword_" + name;
+        result.testName = "position_features";
+        result.inputSize = words.size();
+        result.iterations = rounds;
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = ms;
+        result.throughput = words.size() / ms * 1000.0;  // words per second
+        results.push_back(result);
+        
+        cout << "  " << setw(10) << left << name << right << fixed << setprecision(2)
+             << setw(11) << ms * 1e6 / words.size() << "\n";
+    }
+}
+
+void Benchmark::benchmarkKDTreeApprox(const vector<int>& checks, int queryCount) {
+    cout << "Running best-bin-first kd-tree benchmark (recall@5 against exact search)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    mt19937 rng(17);
+    uniform_int_distribution<int> letter('a', 'z');
+    vector<string> queries;
+    for (int i = 0; i < queryCount; i++) {
+        string typo = words[rng() % words.size()];
+        typo[rng() % typo.length()] = static_cast<char>(letter(rng));
+        queries.push_back(typo);
+    }
+    
+    // Exact k-th neighbour distance per query; many words tie, so an
+    // approximate neighbour counts as found when it is no further than that
+    KDTree* tree = checker->getKDTreePtr();
+    const size_t k = 5;
+    vector<double> kthDistance;
+    size_t exactVisited = 0;
+    for (const string& q : queries) {
+        size_t visited = 0;
+        vector<Position> exact = tree->findKNearest(q, k, &visited);
+        exactVisited += visited;
+        kthDistance.push_back(exact.empty() ? 0.0 : exact.back().distance(Position::fromWord(q)));
+    }
+    double exactMs = measureTime([&]() { for (const string& q : queries) tree->findKNearest(q, k); }) / queries.size();
+    
+    cout << "  Checks     recall   nodes/query   ms/query\n";
+    auto report = [&](const string& name, double recall, double nodes, double ms) {
+        BenchmarkResult result;
+        result.methodName = "kdtree_" + name;
+        result.testName = "kdtree_approx";
+        result.inputSize = words.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = ms;
+        result.throughput = recall;  // recall@5
+        results.push_back(result);
+        
+        cout << "  " << setw(8) << left << name << right << fixed << setprecision(3) << setw(9) << recall
+             << setw(14) << setprecision(1) << nodes << setw(11) << setprecision(4) << ms << "\n";
+    };
+    
+    for (int limit : checks) {
+        size_t found = 0, visitedTotal = 0;
+        for (size_t i = 0; i < queries.size(); i++) {
+            size_t visited = 0;
+            Position target = Position::fromWord(queries[i]);
+            for (const auto& pos : tree->findKNearestApprox(queries[i], k, limit, &visited)) {
+                if (pos.distance(target) <= kthDistance[i] + 1e-9) found++;
+            }
+            visitedTotal += visited;
+        }
+        double ms = measureTime([&]() { for (const string& q : queries) tree->findKNearestApprox(q, k, limit); }) / queries.size();
+        report(to_string(limit), static_cast<double>(found) / (k * queries.size()),
+               static_cast<double>(visitedTotal) / queries.size(), ms);
+    }
+    report("exact", 1.0, static_cast<double>(exactVisited) / queries.size(), exactMs);
+}
+
+void Benchmark::benchmarkKDTreeRerank(const string& misspellingsFile) {
+    cout << "Running kd-tree re-ranking benchmark (" << misspellingsFile << ")...\n";
+    
+    vector<pair<string, string>> queries = loadMisspellings(misspellingsFile);
+    if (queries.empty()) {
+        cout << "  No misspellings with their intended word in the dictionary.\n";
+        return;
+    }
+    
+    // Top-1 = intended word suggested first; top-k = anywhere in the list
+    bool wasReranking = checker->getKDTreeRerank();
+    cout << "  kd-tree      top-1    top-k   ms/query\n";
+    for (bool rerank : {false, true}) {
+        checker->setKDTreeRerank(rerank);
+        int first = 0, anywhere = 0;
+        double totalMs = 0;
+        for (const auto& [typo, intended] : queries) {
+            auto start = chrono::high_resolution_clock::now();
+            vector<string> suggestions = checker->getSuggestionsKDTree(typo);
+            auto end = chrono::high_resolution_clock::now();
+            totalMs += chrono::duration<double, milli>(end - start).count();
+            
+            if (!suggestions.empty() && suggestions[0] == intended) first++;
+            if (find(suggestions.begin(), suggestions.end(), intended) != suggestions.end()) anywhere++;
+        }
+        
+        double n = queries.size();
+        string name = rerank ? "reranked" : "nearest";
+        BenchmarkResult result;
+        result.methodName = "kdtree_" + name;
+        result.testName = "kdtree_rerank";
+        result.inputSize = queries.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = totalMs / n;
+        result.throughput = anywhere / n;  // top-k accuracy
+        results.push_back(result);
+        
+        cout << "  " << setw(10) << left << name << right << fixed << setprecision(3) << setw(9) << first / n
+             << setw(9) << anywhere / n << setw(11) << setprecision(4) << totalMs / n << "\n";
+    }
+    checker->setKDTreeRerank(wasReranking);
+}
+
+void Benchmark::benchmarkBigramIndex(const vector<int>& dimensions, const vector<size_t>& checks,
+                                     const string& misspellingsFile, int queryCount) {
+    cout << "Running bigram embedding benchmark (5-D kd-tree vs VP-tree over hashed bigrams)...\n";
+    
+    const vector<string>& words = checker->getSignatureTable().getWords();
+    if (words.empty()) {
+        cout << "  Dictionary is empty.\n";
+        return;
+    }
+    
+    mt19937 rng(19);
+    uniform_int_distribution<int> letter('a', 'z');
+    vector<string> queries;
+    for (int i = 0; i < queryCount; i++) {
+        string typo = words[rng() % words.size()];
+        typo[rng() % typo.length()] = static_cast<char>(letter(rng));
+        queries.push_back(typo);
+    }
+    vector<pair<string, string>> misspellings = loadMisspellings(misspellingsFile);
+    
+    // Top-5 = intended word among the 5 nearest (no re-ranking), on the
+    // misspellings file; latency and visits on the random typos
+    cout << "  Index          build ms   memory KB   visited/query   ms/query   top-5\n";
+    auto report = [&](const string& name, double buildMs, double memoryKB, double visited, double queryMs,
+                      const function<vector<string>(const string&)>& nearest) {
+        int hits = 0;
+        for (const auto& [typo, intended] : misspellings) {
+            vector<string> found = nearest(typo);
+            if (find(found.begin(), found.end(), intended) != found.end()) hits++;
+        }
+        double accuracy = misspellings.empty() ? 0.0 : static_cast<double>(hits) / misspellings.size();
+        
+        BenchmarkResult result;
+        result.methodName = name;
+        result.testName = "bigram_index";
+        result.inputSize = words.size();
+        result.iterations = queries.size();
+        result.avgTimeMs = result.minTimeMs = result.maxTimeMs = queryMs;
+        result.throughput = accuracy;  // top-5 accuracy
+        results.push_back(result);
+        
+        cout << "  " << setw(13) << left << name << right << fixed << setprecision(2) << setw(10) << buildMs
+             << setw(12) << setprecision(1) << memoryKB << setw(16) << visited
+             << setw(11) << setprecision(4) << queryMs << setw(8) << setprecision(3) << accuracy << "\n";
+    };
+    
+    KDTree kd;
+    double kdBuildMs = measureTime([&]() { kd.build(words); });
+    size_t kdVisited = 0;
+    for (const string& q : queries) {
+        size_t visited = 0;
+        kd.findKNearest(q, 5, &visited);
+        kdVisited += visited;
+    }
+    double kdMs = measureTime([&]() { for (const string& q : queries) kd.findKNearest(q, 5); }) / queries.size();
+    // Per node: the Position (string + vector of 5 doubles) and two child pointers
+    double kdKB = words.size() * (sizeof(KDTreeNode) + 5 * sizeof(double)) / 1024.0;
+    report("kd 5-D", kdBuildMs, kdKB, static_cast<double>(kdVisited) / queries.size(), kdMs, [&](const string& w) {
+        vector<string> found;
+        for (const auto& pos : kd.findKNearest(w, 5)) found.push_back(pos.word);
+        return found;
+    });
+    
+    // Exact VP-tree search at each size, then the default size with a
+    // budget on the distances computed
+    vector<pair<int, size_t>> configs;
+    for (int dims : dimensions) configs.push_back({dims, 0});
+    for (size_t budget : checks) configs.push_back({HashedBigramEmbedding::DEFAULT_DIMENSIONS, budget});
+    
+    for (const auto& [dims, budget] : configs) {
+        VPTree vp(dims);
+        double buildMs = measureTime([&]() { vp.build(words); });
+        size_t vpVisited = 0;
+        for (const string& q : queries) {
+            size_t visited = 0;
+            vp.findKNearest(q, 5, budget, &visited);
+            vpVisited += visited;
+        }
+        double queryMs = measureTime([&, budget = budget]() {
+            for (const string& q : queries) vp.findKNearest(q, 5, budget);
+        }) / queries.size();
+        string name = "vp " + to_string(dims) + "-D" + (budget ? "/" + to_string(budget) : "");
+        report(name, buildMs, vp.memoryBytes() / 1024.0, static_cast<double>(vpVisited) / queries.size(), queryMs,
+               [&, budget = budget](const string& w) {
+            vector<string> found;
+            for (const auto& [dist, word] : vp.findKNearest(w, 5, budget)) found.push_back(word);
+            return found;
+        });
+    }
 }
 
 void Benchmark::benchmarkParallelProcessing(const string& text, int numThreads) {
@@ -244,13 +1313,15 @@ void Benchmark::exportComparisonToCSV(const string& filename) {
         return;
     }
     
-    file << "Word,TrieTime(ms),KDTreeTime(ms),AStarTime(ms),TrieSuggestions,KDTreeSuggestions,AStarSuggestions\n";
+    file << "Word,TrieTime(ms),KDTreeTime(ms),AStarTime(ms),SymSpellTime(ms),"
+         << "TrieSuggestions,KDTreeSuggestions,AStarSuggestions,SymSpellSuggestions\n";
     
     for (const auto& c : comparisons) {
         file << c.word << ","
              << c.trieTimeMs << ","
              << c.kdtreeTimeMs << ","
-             << c.astarTimeMs << ",\"";
+             << c.astarTimeMs << ","
+             << c.symspellTimeMs << ",\"";
         
         for (size_t i = 0; i < c.trieSuggestions.size(); i++) {
             if (i > 0) file << ";";
@@ -268,6 +1339,12 @@ void Benchmark::exportComparisonToCSV(const string& filename) {
             if (i > 0) file << ";";
             file << c.astarSuggestions[i];
         }
+        file << "\",\"";
+        
+        for (size_t i = 0; i < c.symspellSuggestions.size(); i++) {
+            if (i > 0) file << ";";
+            file << c.symspellSuggestions[i];
+        }
         file << "\"\n";
     }
     
@@ -309,6 +1386,7 @@ void Benchmark::generateReport(const string& filename) {
         double bestTime = c.trieTimeMs;
         if (c.kdtreeTimeMs < bestTime) { best = "KD-Tree"; bestTime = c.kdtreeTimeMs; }
         if (c.astarTimeMs < bestTime) { best = "A*"; bestTime = c.astarTimeMs; }
+        if (c.symspellTimeMs < bestTime) { best = "SymSpell"; bestTime = c.symspellTimeMs; }
         
         file << "| " << c.word << " | " << best << " | " << bestTime << " |\n";
     }
@@ -352,16 +1430,18 @@ void Benchmark::printSummary() {
     
     // Comparison summary
     if (!comparisons.empty()) {
-        int trieWins = 0, kdWins = 0, astarWins = 0;
+        int trieWins = 0, kdWins = 0, astarWins = 0, symspellWins = 0;
         for (const auto& c : comparisons) {
-            double minTime = min({c.trieTimeMs, c.kdtreeTimeMs, c.astarTimeMs});
+            double minTime = min({c.trieTimeMs, c.kdtreeTimeMs, c.astarTimeMs, c.symspellTimeMs});
             if (c.trieTimeMs == minTime) trieWins++;
             else if (c.kdtreeTimeMs == minTime) kdWins++;
-            else astarWins++;
+            else if (c.astarTimeMs == minTime) astarWins++;
+            else symspellWins++;
         }
         
         cout << "\nMethod wins: Trie=" << trieWins 
              << ", KD-Tree=" << kdWins 
-             << ", A*=" << astarWins << "\n";
+             << ", A*=" << astarWins
+             << ", SymSpell=" << symspellWins << "\n";
     }
 }
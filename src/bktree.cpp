@@ -0,0 +1,56 @@
+#include "../include/bktree.h"
+#include <algorithm>
+
+void BKTree::insert(const string& word) {
+    if (nodes.empty()) {
+        nodes.push_back(BKTreeNode{word, {}});
+        return;
+    }
+
+    int current = 0;
+    while (true) {
+        int d = simdLevenshtein(word, nodes[current].word, insertScratch);
+        if (d == 0) return;
+
+        vector<pair<int, int>>& children = nodes[current].children;
+        auto it = lower_bound(children.begin(), children.end(), make_pair(d, -1));
+        if (it != children.end() && it->first == d) {
+            current = it->second;
+            continue;
+        }
+
+        // New leaf; push_back may move nodes, so insert the edge first
+        int child = nodes.size();
+        children.insert(it, {d, child});
+        nodes.push_back(BKTreeNode{word, {}});
+        return;
+    }
+}
+
+void BKTree::search(const string& query, int maxDist, vector<pair<int, string>>& results,
+                    size_t* distanceComputations) const {
+    results.clear();
+    if (nodes.empty()) return;
+
+    static thread_local LevenshteinScratch scratch;
+    static thread_local vector<int> stack;
+    stack.clear();
+    stack.push_back(0);
+
+    while (!stack.empty()) {
+        const BKTreeNode& node = nodes[stack.back()];
+        stack.pop_back();
+
+        int d = simdLevenshtein(query, node.word, scratch);
+        if (distanceComputations) (*distanceComputations)++;
+        if (d <= maxDist) {
+            results.push_back({d, node.word});
+        }
+
+        // Triangle inequality: only edges labelled d - maxDist .. d + maxDist
+        auto first = lower_bound(node.children.begin(), node.children.end(), make_pair(d - maxDist, -1));
+        for (auto it = first; it != node.children.end() && it->first <= d + maxDist; ++it) {
+            stack.push_back(it->second);
+        }
+    }
+}
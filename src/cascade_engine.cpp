@@ -0,0 +1,101 @@
+#include "../include/cascade_engine.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+CascadeEngine::CascadeEngine(SpellChecker& sc, int minSugg, double latencyBudgetUs)
+    : checker(sc), engineName("cascade"),
+      engineDescription("Cheapest exact search first, escalating when it finds too few"),
+      minSuggestions(minSugg), budgetUs(latencyBudgetUs) {
+    addStage("symspell-d1", [this](const string& w) { return checker.getSuggestionsSymSpell(w, 1); });
+    if (checker.getMaxEditDistance() > 1) {
+        addStage("symspell-d" + to_string(checker.getMaxEditDistance()),
+                 [this](const string& w) { return checker.getSuggestionsSymSpell(w); });
+    }
+    addStage("phonetic", [this](const string& w) { return checker.getPhoneticCandidates(w); });
+    addStage("kdtree", [this](const string& w) { return checker.getSuggestionsKDTree(w); });
+}
+
+void CascadeEngine::addStage(const string& name, function<vector<string>(const string&)> suggest) {
+    auto stage = make_unique<Stage>();
+    stage->name = name;
+    stage->suggest = move(suggest);
+    stages.push_back(move(stage));
+}
+
+vector<string> CascadeEngine::suggest(const string& word) {
+    queries.fetch_add(1, memory_order_relaxed);
+    size_t limit = checker.getMaxSuggestions();
+    size_t enough = min(limit, static_cast<size_t>(max(minSuggestions, 1)));
+    int stopLevel = checker.getEarlyStopFrequency();
+    vector<string> suggestions;
+
+    auto start = chrono::high_resolution_clock::now();
+    auto stageStart = start;
+    for (size_t i = 0; i < stages.size(); i++) {
+        Stage& stage = *stages[i];
+        if (i > 0 && chrono::duration<double, micro>(stageStart - start).count() >= budgetUs) {
+            budgetStops.fetch_add(1, memory_order_relaxed);
+            break;
+        }
+
+        // Earlier stages are closer matches: keep their order, append new words
+        size_t before = suggestions.size();
+        bool confident = false;
+        for (const string& candidate : stage.suggest(word)) {
+            if (suggestions.size() >= limit) break;
+            if (find(suggestions.begin(), suggestions.end(), candidate) == suggestions.end()) {
+                suggestions.push_back(candidate);
+                confident = confident || (stopLevel > 0 && checker.getWordFrequencyLevel(candidate) >= stopLevel);
+            }
+        }
+
+        auto stageEnd = chrono::high_resolution_clock::now();
+        stage.reached.fetch_add(1, memory_order_relaxed);
+        stage.totalNs.fetch_add(chrono::duration_cast<chrono::nanoseconds>(stageEnd - stageStart).count(),
+                                memory_order_relaxed);
+        if (suggestions.size() > before) stage.hits.fetch_add(1, memory_order_relaxed);
+        stageStart = stageEnd;
+
+        if (suggestions.size() >= enough || confident) {
+            stage.resolved.fetch_add(1, memory_order_relaxed);
+            break;
+        }
+    }
+
+    return suggestions;
+}
+
+vector<CascadeStageStats> CascadeEngine::getStageStats() const {
+    vector<CascadeStageStats> stats;
+    for (const auto& stage : stages) {
+        stats.push_back({stage->name, stage->reached.load(), stage->hits.load(), stage->resolved.load(),
+                         stage->totalNs.load() / 1e6});
+    }
+    return stats;
+}
+
+void CascadeEngine::resetStats() {
+    queries = 0;
+    budgetStops = 0;
+    for (auto& stage : stages) {
+        stage->reached = 0;
+        stage->hits = 0;
+        stage->resolved = 0;
+        stage->totalNs = 0;
+    }
+}
+
+void CascadeEngine::printStats(ostream& out) const {
+    uint64_t total = max<uint64_t>(queries.load(), 1);
+    out << "  Stage          reached   hit rate   resolved   ms/run\n";
+    for (const auto& s : getStageStats()) {
+        out << "  " << setw(13) << left << s.name << right << fixed
+            << setw(9) << setprecision(1) << 100.0 * s.reached / total << "%"
+            << setw(9) << (s.reached ? 100.0 * s.hits / s.reached : 0.0) << "%"
+            << setw(9) << (s.reached ? 100.0 * s.resolved / s.reached : 0.0) << "%"
+            << setw(10) << setprecision(4) << (s.reached ? s.totalMs / s.reached : 0.0) << "\n";
+    }
+    out << "  Stopped by the " << setprecision(0) << budgetUs << " us budget: " << budgetStops.load()
+        << " of " << queries.load() << " queries\n";
+}
@@ -0,0 +1,389 @@
+#include "../include/flat_kdtree.h"
+#include <algorithm>
+
+// (squared distance, id) order: closer first, ties alphabetical like
+// KDTree's, so equally distant words are kept and reported in word order
+struct CloserCandidate {
+    const vector<string>& words;
+
+    bool operator()(const pair<float, int>& a, const pair<float, int>& b) const {
+        if (a.first != b.first) return a.first < b.first;
+        return words[a.second] < words[b.second];
+    }
+};
+
+// Closest-first order for the final results
+static void sortByDistance(vector<pair<float, int>>& found, const vector<string>& words) {
+    sort(found.begin(), found.end(), CloserCandidate{words});
+}
+
+// Keep the k best (squared distance, id) pairs in a max-heap, worst on top
+static void offerCandidate(vector<pair<float, int>>& heap, pair<float, int> candidate, size_t k,
+                           const vector<string>& words) {
+    CloserCandidate closer{words};
+    if (heap.size() < k) {
+        heap.push_back(candidate);
+        push_heap(heap.begin(), heap.end(), closer);
+    } else if (closer(candidate, heap.front())) {
+        pop_heap(heap.begin(), heap.end(), closer);
+        heap.back() = candidate;
+        push_heap(heap.begin(), heap.end(), closer);
+    }
+}
+
+// Nodes in the left subtree of a complete binary tree with n nodes
+static size_t leftSubtreeSize(size_t n) {
+    if (n <= 1) return 0;
+    size_t height = 0;   // floor(log2(n))
+    while ((size_t(2) << height) <= n) height++;
+    size_t bottom = n - ((size_t(1) << height) - 1);   // nodes on the last level
+    size_t half = size_t(1) << (height - 1);           // last-level slots under the left child
+    return (half - 1) + min(bottom, half);
+}
+
+void FlatKDTree::buildRecursive(vector<Point>& points, size_t begin, size_t end, size_t node, size_t depth) {
+    if (begin >= end) return;
+
+    // The split point is the element whose rank makes the left subtree
+    // exactly as large as a complete tree needs
+    size_t axis = depth % DIMENSIONS;
+    size_t mid = begin + leftSubtreeSize(end - begin);
+    nth_element(points.begin() + begin, points.begin() + mid, points.begin() + end,
+                [axis](const Point& a, const Point& b) { return a.coords[axis] < b.coords[axis]; });
+
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        coords[d][node] = points[mid].coords[d];
+    }
+    ids[node] = points[mid].id;
+
+    buildRecursive(points, begin, mid, 2 * node + 1, depth + 1);
+    buildRecursive(points, mid + 1, end, 2 * node + 2, depth + 1);
+}
+
+void FlatKDTree::kNearestRecursive(size_t node, size_t depth, const float* target,
+                                   vector<pair<float, int>>& heap, size_t k, size_t& visited) const {
+    if (node >= ids.size()) return;
+    visited++;
+
+    float dist = 0.0f;
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        float diff = target[d] - coords[d][node];
+        dist += diff * diff;
+    }
+
+    offerCandidate(heap, {dist, ids[node]}, k, words);
+
+    size_t axis = depth % DIMENSIONS;
+    float diff = target[axis] - coords[axis][node];
+    size_t nearSide = (diff < 0) ? 2 * node + 1 : 2 * node + 2;
+    size_t farSide = (diff < 0) ? 2 * node + 2 : 2 * node + 1;
+
+    kNearestRecursive(nearSide, depth + 1, target, heap, k, visited);
+
+    // The far side is at least |diff| away on this axis; at exactly that
+    // distance it can still hold an alphabetically earlier tie
+    if (heap.size() < k || diff * diff <= heap.front().first) {
+        kNearestRecursive(farSide, depth + 1, target, heap, k, visited);
+    }
+}
+
+void FlatKDTree::build(const vector<string>& wordList) {
+    clear();
+    words = wordList;
+
+    vector<Point> points(words.size());
+    for (size_t i = 0; i < words.size(); i++) {
+        Position::fromWord(words[i], points[i].coords);
+        points[i].id = static_cast<int>(i);
+    }
+
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        coords[d].resize(points.size());
+    }
+    ids.resize(points.size());
+    buildRecursive(points, 0, points.size(), 0, 0);
+}
+
+void FlatKDTree::clear() {
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        coords[d].clear();
+    }
+    ids.clear();
+    words.clear();
+}
+
+vector<Position> FlatKDTree::findKNearest(const string& target_word, size_t k, size_t* visited) const {
+    size_t count = 0;
+    vector<Position> results;
+    if (ids.empty() || k == 0) {
+        if (visited) *visited = 0;
+        return results;
+    }
+
+    float target[DIMENSIONS];
+    Position::fromWord(target_word, target);
+
+    vector<pair<float, int>> heap;
+    heap.reserve(k);
+    kNearestRecursive(0, 0, target, heap, k, count);
+    if (visited) *visited = count;
+
+    sortByDistance(heap, words);
+    for (const auto& [dist, id] : heap) {
+        results.push_back(Position::fromWord(words[id]));
+    }
+    return results;
+}
+
+size_t FlatKDTree::memoryBytes() const {
+    size_t bytes = ids.capacity() * sizeof(int);
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        bytes += coords[d].capacity() * sizeof(float);
+    }
+    return bytes;
+}
+
+// BucketKDTree
+
+BucketKDTree::BucketKDTree(size_t leafSize) : leafSize(max<size_t>(1, leafSize)) {}
+
+void BucketKDTree::buildRecursive(vector<uint32_t>& order, const vector<float>* source,
+                                  size_t begin, size_t end, size_t node) {
+    Node& current = nodes[node];
+    current.begin = static_cast<uint32_t>(begin);
+    current.end = static_cast<uint32_t>(end);
+    if (end - begin <= leafSize) return;
+
+    // Split the widest axis at its median point
+    size_t axis = 0;
+    float widest = -1.0f;
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        auto [low, high] = minmax_element(order.begin() + begin, order.begin() + end,
+                                          [&](uint32_t a, uint32_t b) { return source[d][a] < source[d][b]; });
+        float spread = source[d][*high] - source[d][*low];
+        if (spread > widest) {
+            widest = spread;
+            axis = d;
+        }
+    }
+
+    size_t mid = begin + (end - begin) / 2;
+    nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                [&](uint32_t a, uint32_t b) { return source[axis][a] < source[axis][b]; });
+    current.axis = static_cast<uint32_t>(axis);
+    current.split = source[axis][order[mid]];
+
+    buildRecursive(order, source, begin, mid, 2 * node + 1);
+    buildRecursive(order, source, mid, end, 2 * node + 2);
+}
+
+void BucketKDTree::scanLeaf(const Node& leaf, const float* target, vector<pair<float, int>>& heap, size_t k) const {
+    // Distances for the whole bucket, one dimension at a time, so the
+    // inner loop runs over contiguous floats
+    static thread_local vector<float> dist;
+    size_t count = leaf.end - leaf.begin;
+    dist.assign(count, 0.0f);
+    float* out = dist.data();
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        const float* c = coords[d].data() + leaf.begin;
+        float t = target[d];
+        #ifdef _OPENMP
+        #pragma omp simd
+        #endif
+        for (size_t j = 0; j < count; j++) {
+            float diff = t - c[j];
+            out[j] += diff * diff;
+        }
+    }
+
+    for (size_t j = 0; j < count; j++) {
+        offerCandidate(heap, {out[j], ids[leaf.begin + j]}, k, words);
+    }
+}
+
+void BucketKDTree::kNearestRecursive(size_t node, const float* target, vector<pair<float, int>>& heap,
+                                     size_t k, size_t& scanned) const {
+    const Node& current = nodes[node];
+    size_t count = current.end - current.begin;
+
+    if (count <= leafSize) {
+        scanLeaf(current, target, heap, k);
+        scanned += count;
+        return;
+    }
+
+    float diff = target[current.axis] - current.split;
+    size_t nearSide = (diff < 0) ? 2 * node + 1 : 2 * node + 2;
+    size_t farSide = (diff < 0) ? 2 * node + 2 : 2 * node + 1;
+
+    kNearestRecursive(nearSide, target, heap, k, scanned);
+    if (heap.size() < k || diff * diff <= heap.front().first) {
+        kNearestRecursive(farSide, target, heap, k, scanned);
+    }
+}
+
+void BucketKDTree::batchRecursive(size_t node, vector<BatchQuery>& queries, const vector<uint32_t>& active,
+                                  size_t k) const {
+    const Node& current = nodes[node];
+    if (current.end - current.begin <= leafSize) {
+        // The bucket stays in cache while every query in the group scans it
+        for (uint32_t q : active) {
+            scanLeaf(current, queries[q].target, queries[q].heap, k);
+        }
+        return;
+    }
+
+    auto needsFarSide = [&](uint32_t q) {
+        float diff = queries[q].target[current.axis] - current.split;
+        return queries[q].heap.size() < k || diff * diff <= queries[q].heap.front().first;
+    };
+
+    // Group the queries by the side they descend first
+    vector<uint32_t> leftFirst, rightFirst;
+    for (uint32_t q : active) {
+        (queries[q].target[current.axis] < current.split ? leftFirst : rightFirst).push_back(q);
+    }
+    size_t left = 2 * node + 1, right = 2 * node + 2;
+
+    // Every query finishes its near side before its far side: left-first
+    // queries go left, then join the right-first ones going right (after
+    // the pruning test), then the right-first ones that still need it go left
+    size_t rightFirstCount = rightFirst.size();
+    if (!leftFirst.empty()) {
+        batchRecursive(left, queries, leftFirst, k);
+    }
+    for (uint32_t q : leftFirst) {
+        if (needsFarSide(q)) rightFirst.push_back(q);
+    }
+    if (!rightFirst.empty()) {
+        batchRecursive(right, queries, rightFirst, k);
+    }
+    vector<uint32_t> rightFar;
+    for (size_t i = 0; i < rightFirstCount; i++) {
+        if (needsFarSide(rightFirst[i])) rightFar.push_back(rightFirst[i]);
+    }
+    if (!rightFar.empty()) {
+        batchRecursive(left, queries, rightFar, k);
+    }
+}
+
+void BucketKDTree::build(const vector<string>& wordList) {
+    clear();
+    words = wordList;
+    size_t n = words.size();
+    if (n == 0) return;
+
+    vector<float> source[DIMENSIONS];
+    float* columns[DIMENSIONS];
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        source[d].resize(n);
+        columns[d] = source[d].data();
+    }
+    Position::fromWords(words, columns);
+
+    // Halving until a range fits in a leaf gives the number of levels
+    size_t levels = 0;
+    for (size_t remaining = n; remaining > leafSize; remaining = (remaining + 1) / 2) {
+        levels++;
+    }
+    nodes.assign((size_t(2) << levels) - 1, Node{0.0f, 0, 0, 0});
+
+    vector<uint32_t> order(n);
+    for (size_t i = 0; i < n; i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    buildRecursive(order, source, 0, n, 0);
+
+    // Lay the points out in leaf order
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        coords[d].resize(n);
+        for (size_t i = 0; i < n; i++) {
+            coords[d][i] = source[d][order[i]];
+        }
+    }
+    ids.assign(order.begin(), order.end());
+}
+
+void BucketKDTree::clear() {
+    nodes.clear();
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        coords[d].clear();
+    }
+    ids.clear();
+    words.clear();
+}
+
+vector<Position> BucketKDTree::findKNearest(const string& target_word, size_t k, size_t* scanned) const {
+    size_t count = 0;
+    vector<Position> results;
+    if (ids.empty() || k == 0) {
+        if (scanned) *scanned = 0;
+        return results;
+    }
+
+    float target[DIMENSIONS];
+    Position::fromWord(target_word, target);
+
+    vector<pair<float, int>> heap;
+    heap.reserve(k);
+    kNearestRecursive(0, target, heap, k, count);
+    if (scanned) *scanned = count;
+
+    sortByDistance(heap, words);
+    for (const auto& [dist, id] : heap) {
+        results.push_back(Position::fromWord(words[id]));
+    }
+    return results;
+}
+
+vector<vector<Position>> BucketKDTree::findKNearestBatch(const vector<string>& targets, size_t k, int threads) const {
+    vector<vector<Position>> results(targets.size());
+    if (ids.empty() || k == 0 || targets.empty()) return results;
+
+    vector<BatchQuery> queries(targets.size());
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(max(threads, 1)) schedule(static)
+    #endif
+    for (size_t i = 0; i < targets.size(); i++) {
+        Position::fromWord(targets[i], queries[i].target);
+        queries[i].heap.reserve(k);
+    }
+
+    // Neighbouring queries walk mostly the same branches: order the batch by
+    // position so each thread's slice groups well
+    vector<uint32_t> order(targets.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    sort(order.begin(), order.end(), [&queries](uint32_t a, uint32_t b) {
+        return lexicographical_compare(queries[a].target, queries[a].target + DIMENSIONS,
+                                       queries[b].target, queries[b].target + DIMENSIONS);
+    });
+
+    int slices = max(1, min(threads, static_cast<int>(order.size())));
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(slices) schedule(static, 1)
+    #endif
+    for (int slice = 0; slice < slices; slice++) {
+        size_t begin = order.size() * slice / slices;
+        size_t end = order.size() * (slice + 1) / slices;
+        vector<uint32_t> active(order.begin() + begin, order.begin() + end);
+        batchRecursive(0, queries, active, k);
+
+        for (uint32_t q : active) {
+            sortByDistance(queries[q].heap, words);
+            for (const auto& [dist, id] : queries[q].heap) {
+                results[q].push_back(Position::fromWord(words[id]));
+            }
+        }
+    }
+    return results;
+}
+
+size_t BucketKDTree::memoryBytes() const {
+    size_t bytes = nodes.capacity() * sizeof(Node) + ids.capacity() * sizeof(int);
+    for (size_t d = 0; d < DIMENSIONS; d++) {
+        bytes += coords[d].capacity() * sizeof(float);
+    }
+    return bytes;
+}
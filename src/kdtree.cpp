@@ -1,4 +1,11 @@
 #include "../include/kdtree.h"
+#include <array>
+#include <cstdint>
+#include <queue>
+#include <tuple>
+
+// Subtrees smaller than this are built by the task that reaches them
+static const size_t PARALLEL_BUILD_CUTOFF = 4096;
 
 // Position methods
 
@@ -15,91 +22,173 @@ bool Position::operator<(const Position& other) const {
     return word < other.word;
 }
 
-Position Position::fromWord(const string& word) {
-    size_t dimensions = 5;
-    Position pos;
-    pos.word = word;
-    pos.coords.assign(dimensions, 0.0);
-
-    size_t total_letters = 0;
-    size_t vowel_count = 0;
-    double common_letter_freq_sum = 0.0;
-    size_t first_half_count = 0;  // a-m
-    size_t second_half_count = 0; // n-z
-
-    // calculate frequencies
-    for (char ch : word)
-    {
-        if (isalpha(static_cast<unsigned char>(ch)))
-        {
-            char lower_ch = tolower(ch);
-            total_letters++;
-
-            if (lower_ch == 'a' || lower_ch == 'e' || lower_ch == 'i' || lower_ch == 'o' || lower_ch == 'u')
-            {
-                vowel_count++;
-            }
+// Letter classes behind Position::fromWord's coordinates, on a lowercased byte
+static constexpr bool isLetter(int lower) { return lower >= 'a' && lower <= 'z'; }
+static constexpr bool isFirstHalf(int lower) { return lower >= 'a' && lower <= 'm'; }
+static constexpr bool isVowel(int lower) {
+    return lower == 'a' || lower == 'e' || lower == 'i' || lower == 'o' || lower == 'u';
+}
+static constexpr bool isCommon(int lower) {
+    return lower == 'e' || lower == 't' || lower == 'a' || lower == 'i' || lower == 'n' || lower == 'o';
+}
 
-            if (lower_ch == 'e' || lower_ch == 't' || lower_ch == 'a' ||
-                lower_ch == 'i' || lower_ch == 'n' || lower_ch == 'o')
-            {
-                common_letter_freq_sum += 1.0;
-            }
+// Counts of one byte in four byte fields, so a word's counts are the sum
+// of its characters' entries: letter, vowel, common letter, a-m letter
+static const uint32_t LETTER = 1u, VOWEL = 1u << 8, COMMON = 1u << 16, FIRST_HALF = 1u << 24;
 
-            if (lower_ch >= 'a' && lower_ch <= 'm')
-            {
-                first_half_count++;
-            }
-            else if (lower_ch >= 'n' && lower_ch <= 'z')
-            {
-                second_half_count++;
-            }
-        }
+static constexpr array<uint32_t, 256> makeCharClasses() {
+    array<uint32_t, 256> table{};
+    for (int i = 0; i < 256; i++) {
+        int lower = (i >= 'A' && i <= 'Z') ? i - 'A' + 'a' : i;
+        table[i] = isLetter(lower) * LETTER + isVowel(lower) * VOWEL + isCommon(lower) * COMMON +
+                   isFirstHalf(lower) * FIRST_HALF;
     }
+    return table;
+}
 
-    double len_norm = 1.0; // normalize from word length
-    if (total_letters > 0)
-    {
-        // dimension 1: normalized word length
-        pos.coords[0] = min(1.0, (double)total_letters / 20.0);
+// Weight of a byte as the first character: lowercased byte - 'a' + 1, with
+// the byte read as a (signed) char
+static constexpr array<int16_t, 256> makeFirstRanks() {
+    array<int16_t, 256> table{};
+    for (int i = 0; i < 256; i++) {
+        int ch = i < 128 ? i : i - 256;
+        int lower = (ch >= 'A' && ch <= 'Z') ? ch - 'A' + 'a' : ch;
+        table[i] = static_cast<int16_t>(lower - 'a' + 1);
+    }
+    return table;
+}
 
-        // dimension 2: vowel ratio
-        pos.coords[1] = (double)vowel_count / total_letters;
+static constexpr array<uint32_t, 256> CHAR_CLASSES = makeCharClasses();
+static constexpr array<int16_t, 256> FIRST_RANKS = makeFirstRanks();
 
-        // dimension 3: common letter ratio
-        pos.coords[2] = common_letter_freq_sum / total_letters;
+// Characters summed into one table entry before a byte field can overflow
+static const size_t COUNT_SPAN = 255;
 
-        // dimension 4: first half
-        pos.coords[3] = (double)(first_half_count - second_half_count) / total_letters;
+// Batches smaller than this are not worth starting threads for
+static const size_t PARALLEL_FEATURES_CUTOFF = 4096;
 
-        // dimension 5: first letter weight
-        char first_char = tolower(word[0]);
-        pos.coords[4] = (double)(first_char - 'a' + 1) / 26.0;
+// Coordinates from a word's class counts
+template <typename T>
+static void coordsFromCounts(int letters, int vowels, int common, int balance, int firstRank, T* coords) {
+    if (letters == 0) {
+        for (size_t d = 0; d < Position::DIMENSIONS; d++) coords[d] = 0;
+        return;
     }
+    double total = letters;
+    // dimension 1: normalized word length
+    coords[0] = static_cast<T>(min(1.0, total / 20.0));
+    // dimension 2: vowel ratio
+    coords[1] = static_cast<T>(vowels / total);
+    // dimension 3: common letter ratio
+    coords[2] = static_cast<T>(common / total);
+    // dimension 4: a-m letters minus n-z letters
+    coords[3] = static_cast<T>(balance / total);
+    // dimension 5: first letter weight
+    coords[4] = static_cast<T>(firstRank / 26.0);
+}
+
+template <typename T>
+static void coordsFromWord(const string& word, T* coords) {
+    const unsigned char* text = reinterpret_cast<const unsigned char*>(word.data());
+    int letters = 0, vowels = 0, common = 0, firstHalf = 0;
+    for (size_t begin = 0; begin < word.length(); begin += COUNT_SPAN) {
+        size_t end = min(word.length(), begin + COUNT_SPAN);
+        uint32_t counts = 0;
+        for (size_t i = begin; i < end; i++) {
+            counts += CHAR_CLASSES[text[i]];
+        }
+        letters += counts & 0xFF;
+        vowels += (counts >> 8) & 0xFF;
+        common += (counts >> 16) & 0xFF;
+        firstHalf += counts >> 24;
+    }
+    int firstRank = word.empty() ? 0 : FIRST_RANKS[text[0]];
+    coordsFromCounts(letters, vowels, common, 2 * firstHalf - letters, firstRank, coords);
+}
+
+Position Position::fromWord(const string& word) {
+    Position pos;
+    pos.word = word;
+    pos.coords.resize(DIMENSIONS);
+    coordsFromWord(word, pos.coords.data());
     return pos;
 }
 
-// KDTree private methods
+void Position::fromWord(const string& word, double coords[DIMENSIONS]) {
+    coordsFromWord(word, coords);
+}
+
+void Position::fromWord(const string& word, float coords[DIMENSIONS]) {
+    coordsFromWord(word, coords);
+}
 
-KDTreeNode* KDTree::insertRecursive(KDTreeNode* node, const Position& pos, size_t depth) {
-    // Base case: found insertion spot
-    if (!node) {
-        return new KDTreeNode(pos);
+void Position::fromWords(const vector<string>& words, float* const coords[DIMENSIONS]) {
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(words.size() > PARALLEL_FEATURES_CUTOFF)
+    #endif
+    for (size_t i = 0; i < words.size(); i++) {
+        float point[DIMENSIONS];
+        coordsFromWord(words[i], point);
+        for (size_t d = 0; d < DIMENSIONS; d++) {
+            coords[d][i] = point[d];
+        }
     }
+}
 
-    // Select axis based on depth so that all dimensions are cycled through
-    size_t axis = depth % dimensions;
+// KDTree private methods
 
-    // Compare position at current dimension and go left or right
-    if (pos.coords[axis] < node->pos.coords[axis]) {
-        node->left = insertRecursive(node->left, pos, depth + 1);
-    } else {
-        node->right = insertRecursive(node->right, pos, depth + 1);
-    }
+KDTreeNode* KDTree::buildRecursive(vector<Position>& positions, size_t begin, size_t end, size_t depth) {
+    if (begin >= end) return nullptr;
+
+    // Median on this level's axis: smaller coordinates end up left of mid,
+    // larger ones right, as insert would place them
+    size_t axis = depth % dimensions;
+    size_t mid = begin + (end - begin) / 2;
+    nth_element(positions.begin() + begin, positions.begin() + mid, positions.begin() + end,
+                [axis](const Position& a, const Position& b) { return a.coords[axis] < b.coords[axis]; });
+
+    KDTreeNode* node = new KDTreeNode(move(positions[mid]));
+
+    // The two halves are disjoint ranges, so they can be built concurrently
+    #ifdef _OPENMP
+    #pragma omp task shared(positions) if(mid - begin > PARALLEL_BUILD_CUTOFF)
+    #endif
+    node->left = buildRecursive(positions, begin, mid, depth + 1);
+    node->right = buildRecursive(positions, mid + 1, end, depth + 1);
+    #ifdef _OPENMP
+    #pragma omp taskwait
+    #endif
 
     return node;
 }
 
+size_t KDTree::depthRecursive(const KDTreeNode* node) const {
+    if (!node) return 0;
+    return 1 + max(depthRecursive(node->left), depthRecursive(node->right));
+}
+
+size_t KDTree::countRecursive(const KDTreeNode* node) const {
+    if (!node) return 0;
+    return 1 + countRecursive(node->left) + countRecursive(node->right);
+}
+
+void KDTree::flattenRecursive(KDTreeNode* node, vector<Position>& out) {
+    if (!node) return;
+    flattenRecursive(node->left, out);
+    flattenRecursive(node->right, out);
+    out.push_back(move(node->pos));
+    delete node;
+}
+
+void KDTree::rebuildSubtree(KDTreeNode** slot, size_t depth) {
+    vector<Position> positions;
+    flattenRecursive(*slot, positions);
+    // Starting at the subtree's own depth keeps the axis cycle of the
+    // levels above it
+    *slot = buildRecursive(positions, 0, positions.size(), depth);
+    rebuildCount++;
+}
+
 void KDTree::clearRecursive(KDTreeNode* node) {
     if (!node) return;
     clearRecursive(node->left);
@@ -107,36 +196,61 @@ void KDTree::clearRecursive(KDTreeNode* node) {
     delete node;
 }
 
-void KDTree::kNearestRecursive(KDTreeNode* node, const Position& target, size_t depth,
-                       vector<pair<double, Position>>& candidates, size_t k) {
-    if (!node) return;
+// Heap order: larger squared distance first, ties broken alphabetically
+// so equally distant words are kept and reported in word order
+static bool closerCandidate(const pair<double, const KDTreeNode*>& a, const pair<double, const KDTreeNode*>& b) {
+    if (a.first != b.first) return a.first < b.first;
+    return a.second->pos.word < b.second->pos.word;
+}
 
-    double dist = node->pos.distance(target);
-    candidates.push_back({dist, node->pos});
+static double squaredDistance(const Position& a, const Position& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.coords.size(); ++i) {
+        double diff = a.coords[i] - b.coords[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
 
-    // keep only k best candidates
-    sort(candidates.begin(), candidates.end());
-    if (candidates.size() > k) {
-        candidates.resize(k);
+// keep only the k best candidates: replace the worst when this one is closer
+static void offerCandidate(vector<pair<double, const KDTreeNode*>>& heap,
+                           pair<double, const KDTreeNode*> candidate, size_t k) {
+    if (heap.size() < k) {
+        heap.push_back(candidate);
+        push_heap(heap.begin(), heap.end(), closerCandidate);
+    } else if (closerCandidate(candidate, heap.front())) {
+        pop_heap(heap.begin(), heap.end(), closerCandidate);
+        heap.back() = candidate;
+        push_heap(heap.begin(), heap.end(), closerCandidate);
     }
+}
+
+void KDTree::kNearestRecursive(const KDTreeNode* node, const Position& target, size_t depth,
+                       vector<pair<double, const KDTreeNode*>>& heap, size_t k, size_t& visited) const {
+    if (!node) return;
+    visited++;
+
+    offerCandidate(heap, {squaredDistance(node->pos, target), node}, k);
 
     size_t axis = depth % dimensions;
     double diff = target.coords[axis] - node->pos.coords[axis];
 
-    KDTreeNode* nearSide = (diff < 0) ? node->left : node->right;
-    KDTreeNode* farSide = (diff < 0) ? node->right : node->left;
+    const KDTreeNode* nearSide = (diff < 0) ? node->left : node->right;
+    const KDTreeNode* farSide = (diff < 0) ? node->right : node->left;
 
-    kNearestRecursive(nearSide, target, depth + 1, candidates, k);
+    kNearestRecursive(nearSide, target, depth + 1, heap, k, visited);
 
-    // check to explore far side
-    if (candidates.size() < k || diff * diff < candidates.back().first) {
-        kNearestRecursive(farSide, target, depth + 1, candidates, k);
+    // check to explore far side: it is at least |diff| away, compared squared
+    // like the heap's distances
+    if (heap.size() < k || diff * diff <= heap.front().first) {
+        kNearestRecursive(farSide, target, depth + 1, heap, k, visited);
     }
 }
 
 // KDTree public methods
 
-KDTree::KDTree() : root(nullptr), dimensions(5) {}
+KDTree::KDTree()
+    : root(nullptr), dimensions(5), nodeCount(0), balanceFactor(DEFAULT_BALANCE_FACTOR), rebuildCount(0) {}
 
 KDTree::~KDTree() {
     clearRecursive(root);
@@ -149,25 +263,135 @@ void KDTree::insert(const string word) {
         cerr << "Position dimensions do not match KD-Tree dimensions" << endl;
         return;
     }
-    root = insertRecursive(root, pos, 0);
+
+    // Walk down to the empty slot, remembering the slots passed on the way
+    vector<KDTreeNode**> path;
+    KDTreeNode** slot = &root;
+    size_t depth = 0;
+    while (*slot) {
+        path.push_back(slot);
+        size_t axis = depth % dimensions;
+        slot = pos.coords[axis] < (*slot)->pos.coords[axis] ? &(*slot)->left : &(*slot)->right;
+        depth++;
+    }
+    *slot = new KDTreeNode(move(pos));
+    nodeCount++;
+
+    if (balanceFactor >= 1.0 || depth <= log(static_cast<double>(nodeCount)) / log(1.0 / balanceFactor)) {
+        return;
+    }
+
+    // Too deep, so some ancestor is unbalanced: find the first one going
+    // up, counting only the sibling subtrees not already counted
+    const KDTreeNode* child = *slot;
+    size_t childSize = 1;
+    for (size_t i = path.size(); i-- > 0;) {
+        const KDTreeNode* node = *path[i];
+        const KDTreeNode* sibling = node->left == child ? node->right : node->left;
+        size_t nodeSize = childSize + countRecursive(sibling) + 1;
+        if (childSize > balanceFactor * nodeSize) {
+            rebuildSubtree(path[i], i);
+            return;
+        }
+        child = node;
+        childSize = nodeSize;
+    }
 }
 
-vector<Position> KDTree::findKNearest(const string target_word, size_t k) {
+void KDTree::build(const vector<string>& words) {
+    clear();
+
+    vector<Position> positions(words.size());
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (size_t i = 0; i < words.size(); i++) {
+        positions[i] = Position::fromWord(words[i]);
+    }
+
+    #ifdef _OPENMP
+    #pragma omp parallel
+    #pragma omp single
+    #endif
+    root = buildRecursive(positions, 0, positions.size(), 0);
+    nodeCount = positions.size();
+}
+
+void KDTree::clear() {
+    clearRecursive(root);
+    root = nullptr;
+    nodeCount = 0;
+}
+
+vector<Position> KDTree::findKNearest(const string target_word, size_t k, size_t* visited) {
     Position target = Position::fromWord(target_word);
-    vector<pair<double, Position>> candidates;
+    vector<pair<double, const KDTreeNode*>> heap;
 
     if (!root) {
         cerr << "No words in KD-Tree." << endl;
         return {};
     }
+    if (k == 0) return {};
 
-    kNearestRecursive(root, target, 0, candidates, k);
+    heap.reserve(k);
+    size_t count = 0;
+    kNearestRecursive(root, target, 0, heap, k, count);
+    if (visited) *visited = count;
+
+    // sort by distance and copy out only the k results
+    sort_heap(heap.begin(), heap.end(), closerCandidate);
+    vector<Position> results;
+    results.reserve(heap.size());
+    for (const auto& [dist, node] : heap) {
+        results.push_back(node->pos);
+    }
+    return results;
+}
+
+vector<Position> KDTree::findKNearestApprox(const string target_word, size_t k, size_t maxChecks, size_t* visited) {
+    if (!root) {
+        cerr << "No words in KD-Tree." << endl;
+        return {};
+    }
+    if (k == 0) return {};
+
+    Position target = Position::fromWord(target_word);
+    vector<pair<double, const KDTreeNode*>> heap;
+    heap.reserve(k);
+
+    // Unexplored branches: (squared distance bound, node, depth), closest first
+    using Branch = tuple<double, const KDTreeNode*, size_t>;
+    priority_queue<Branch, vector<Branch>, greater<Branch>> branches;
+    branches.push({0.0, root, 0});
+
+    size_t checks = 0;
+    while (!branches.empty() && (maxChecks == 0 || checks < maxChecks)) {
+        auto [bound, node, depth] = branches.top();
+        branches.pop();
+        if (heap.size() == k && bound > heap.front().first) break;   // nothing closer is left
+
+        // Follow the near side down to a leaf, queueing each far side
+        while (node && (maxChecks == 0 || checks < maxChecks)) {
+            checks++;
+            offerCandidate(heap, {squaredDistance(node->pos, target), node}, k);
+
+            size_t axis = depth % dimensions;
+            double diff = target.coords[axis] - node->pos.coords[axis];
+            const KDTreeNode* farSide = (diff < 0) ? node->right : node->left;
+            if (farSide && (heap.size() < k || diff * diff <= heap.front().first)) {
+                branches.push({max(bound, diff * diff), farSide, depth + 1});
+            }
+            node = (diff < 0) ? node->left : node->right;
+            depth++;
+        }
+    }
+    if (visited) *visited = checks;
 
-    // sort by distance and get positions
-    sort(candidates.begin(), candidates.end());
+    sort_heap(heap.begin(), heap.end(), closerCandidate);
     vector<Position> results;
-    for (const auto& [dist, pos] : candidates) {
-        results.push_back(pos);
+    results.reserve(heap.size());
+    for (const auto& [dist, node] : heap) {
+        results.push_back(node->pos);
     }
     return results;
 }
@@ -0,0 +1,93 @@
+#include "../include/length_shards.h"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+LengthShardedIndex::LengthShardedIndex() : wordCount(0), parallel(false) {}
+
+void LengthShardedIndex::insert(const string& word, int wordId) {
+    if (word.length() >= shards.size()) {
+        shards.resize(word.length() + 1);
+    }
+    if (!shards[word.length()]) {
+        shards[word.length()] = make_unique<Shard>();
+    }
+    Shard& shard = *shards[word.length()];
+    shard.trie.insert(word, wordId);
+    shard.kdtree.insert(word);
+    shard.words++;
+    wordCount++;
+}
+
+void LengthShardedIndex::clear() {
+    shards.clear();
+    wordCount = 0;
+}
+
+vector<LengthShardedIndex::Shard*> LengthShardedIndex::shardsFor(size_t length, int maxDist) const {
+    vector<Shard*> result;
+    size_t low = length > static_cast<size_t>(maxDist) ? length - maxDist : 0;
+    size_t high = min(length + maxDist, shards.empty() ? 0 : shards.size() - 1);
+    for (size_t len = low; len <= high && len < shards.size(); len++) {
+        if (shards[len] && shards[len]->words > 0) {
+            result.push_back(shards[len].get());
+        }
+    }
+    return result;
+}
+
+vector<string> LengthShardedIndex::getSimilarWords(const string& word, int maxDist, TrieSearch search) {
+    vector<Shard*> relevant = shardsFor(word.length(), maxDist);
+    vector<vector<string>> perShard(relevant.size());
+
+    // Only worth forking when this is not already inside a parallel region
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) if(parallel && relevant.size() > 1 && !omp_in_parallel())
+    #endif
+    for (size_t i = 0; i < relevant.size(); i++) {
+        perShard[i] = search(relevant[i]->trie, word, maxDist);
+    }
+
+    vector<string> results;
+    for (auto& found : perShard) {
+        results.insert(results.end(), make_move_iterator(found.begin()), make_move_iterator(found.end()));
+    }
+    return results;
+}
+
+vector<Position> LengthShardedIndex::findKNearest(const string& word, size_t k, int maxDist) {
+    vector<Shard*> relevant = shardsFor(word.length(), maxDist);
+    vector<vector<Position>> perShard(relevant.size());
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) if(parallel && relevant.size() > 1 && !omp_in_parallel())
+    #endif
+    for (size_t i = 0; i < relevant.size(); i++) {
+        perShard[i] = relevant[i]->kdtree.findKNearest(word, k);
+    }
+
+    // Each shard returns its own k best; keep the k best overall
+    Position target = Position::fromWord(word);
+    vector<pair<double, Position>> candidates;
+    for (auto& found : perShard) {
+        for (auto& pos : found) {
+            double dist = pos.distance(target);
+            candidates.push_back({dist, move(pos)});
+        }
+    }
+    sort(candidates.begin(), candidates.end());
+    if (candidates.size() > k) {
+        candidates.resize(k);
+    }
+
+    vector<Position> results;
+    for (auto& [dist, pos] : candidates) {
+        results.push_back(move(pos));
+    }
+    return results;
+}
+
+size_t LengthShardedIndex::shardCount() const {
+    return count_if(shards.begin(), shards.end(), [](const unique_ptr<Shard>& s) { return s && s->words > 0; });
+}
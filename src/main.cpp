@@ -11,6 +11,32 @@
 
 using namespace std;
 
+// Frequency options shared by every mode that builds a SpellChecker
+struct FrequencyOptions {
+    string path;        // "word count" file, empty for none
+    int stopLevel = 0;  // early-stop frequency level, 0 = off
+};
+
+void applyFrequencyOptions(SpellChecker& checker, const FrequencyOptions& options) {
+    if (!options.path.empty()) {
+        checker.loadFrequencies(options.path);
+    }
+    checker.setEarlyStopFrequency(static_cast<uint8_t>(options.stopLevel));
+}
+
+// kd-tree search options shared by every mode that builds a SpellChecker
+struct KDTreeOptions {
+    int checks = 0;       // node budget for approximate search, 0 = exact
+    bool rerank = false;  // re-rank over-fetched neighbours by edit distance
+    int bigrams = 0;      // bigram embedding dimensions, 0 = off
+};
+
+void applyKDTreeOptions(SpellChecker& checker, const KDTreeOptions& options) {
+    checker.setKDTreeChecks(options.checks);
+    checker.setKDTreeRerank(options.rerank);
+    checker.setKDTreeBigrams(options.bigrams > 0, options.bigrams);
+}
+
 void printUsage(const char* programName) {
     cout << "Usage: " << programName << " [options]\n\n";
     cout << "Options:\n";
@@ -19,7 +45,16 @@ void printUsage(const char* programName) {
     cout << "  --check <word>        Check a single word\n";
     cout << "  --file <path>         Check a file\n";
     cout << "  --dict <path>         Specify dictionary file (default: data/dictionary.txt)\n";
-    cout << "  --method <name>       Specify method: astar, trie, kdtree (default: astar)\n";
+    cout << "  --method <name>       Specify method: astar, trie, kdtree, symspell, bktree,\n";
+    cout << "                        qgram, cascade (default: astar)\n";
+    cout << "  --phonetic            Add sound-alike suggestions to --file results\n";
+    cout << "  --freq <file>         Load word frequencies (\"word count\" lines) for ranking\n";
+    cout << "  --freq-stop <level>   Stop searching at a candidate this frequent (0-255)\n";
+    cout << "  --kdtree-checks <n>   Approximate kdtree search checking at most n nodes\n";
+    cout << "  --kdtree-rerank       Re-rank over-fetched kdtree neighbours by edit distance\n";
+    cout << "  --kdtree-bigrams <n>  Answer kdtree queries from n-dimensional bigram vectors (32-64)\n";
+    cout << "  --build-freq <corpus> <out>\n";
+    cout << "                        Count the words of a corpus into a frequency file\n";
     cout << "  --parallel <file>     Process file with parallel spell checking\n";
     cout << "  --tone <file>         Analyze tone of a text file\n";
     cout << "  --visualize           Show visualization of benchmark results\n";
@@ -36,6 +71,10 @@ int main(int argc, char* argv[]) {
     string targetFile = "";
     string exportFile = "";
     int numThreads = 4;
+    bool phoneticMerge = false;
+    FrequencyOptions frequencyOptions;
+    KDTreeOptions kdtreeOptions;
+    string frequencyOutput = "";
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -68,6 +107,26 @@ int main(int argc, char* argv[]) {
             dictionaryPath = argv[++i];
         } else if (arg == "--method" && i + 1 < argc) {
             method = argv[++i];
+        } else if (arg == "--phonetic") {
+            phoneticMerge = true;
+        } else if (arg == "--freq" && i + 1 < argc) {
+            frequencyOptions.path = argv[++i];
+        } else if (arg == "--freq-stop" && i + 1 < argc) {
+            frequencyOptions.stopLevel = stoi(argv[++i]);
+            if (frequencyOptions.stopLevel < 0 || frequencyOptions.stopLevel > 255) {
+                cerr << "Error: --freq-stop must be between 0 and 255\n";
+                return 1;
+            }
+        } else if (arg == "--kdtree-checks" && i + 1 < argc) {
+            kdtreeOptions.checks = max(0, stoi(argv[++i]));
+        } else if (arg == "--kdtree-rerank") {
+            kdtreeOptions.rerank = true;
+        } else if (arg == "--kdtree-bigrams" && i + 1 < argc) {
+            kdtreeOptions.bigrams = max(0, stoi(argv[++i]));
+        } else if (arg == "--build-freq" && i + 2 < argc) {
+            mode = "buildfreq";
+            targetFile = argv[++i];
+            frequencyOutput = argv[++i];
         } else if (arg == "--threads" && i + 1 < argc) {
             numThreads = stoi(argv[++i]);
         }
@@ -91,6 +150,8 @@ int main(int argc, char* argv[]) {
         if (!checker.loadDictionary(dictionaryPath)) {
             cerr << "Warning: Could not load dictionary. Using empty dictionary.\n";
         }
+        applyFrequencyOptions(checker, frequencyOptions);
+        applyKDTreeOptions(checker, kdtreeOptions);
         
         Benchmark bench(&checker);
         bench.runAllBenchmarks();
@@ -102,12 +163,17 @@ int main(int argc, char* argv[]) {
         // Single word check mode
         SpellChecker checker(2, 5);
         checker.loadDictionary(dictionaryPath);
+        applyFrequencyOptions(checker, frequencyOptions);
+        applyKDTreeOptions(checker, kdtreeOptions);
         checker.compareMethodsForWord(targetWord);
         
     } else if (mode == "file") {
         // File check mode
         SpellChecker checker(2, 5);
         checker.loadDictionary(dictionaryPath);
+        applyFrequencyOptions(checker, frequencyOptions);
+        applyKDTreeOptions(checker, kdtreeOptions);
+        checker.setPhoneticMerge(phoneticMerge);
         
         SpellCheckResult result = checker.checkFile(targetFile, method);
         
@@ -130,6 +196,8 @@ int main(int argc, char* argv[]) {
         cout << "Loading dictionary from: " << dictionaryPath << "\n";
         SpellChecker checker(2, 5);
         checker.loadDictionary(dictionaryPath);
+        applyFrequencyOptions(checker, frequencyOptions);
+        applyKDTreeOptions(checker, kdtreeOptions);
         
         cout << "Processing file with " << numThreads << " threads...\n\n";
         
@@ -167,6 +235,8 @@ int main(int argc, char* argv[]) {
         
         SpellChecker checker(2, 5);
         checker.loadDictionary(dictionaryPath);
+        applyFrequencyOptions(checker, frequencyOptions);
+        applyKDTreeOptions(checker, kdtreeOptions);
         
         Benchmark bench(&checker);
         bench.runAllBenchmarks();
@@ -197,6 +267,13 @@ int main(int argc, char* argv[]) {
         
         bench.exportToCSV("benchmark_results.csv");
         bench.generateReport("benchmark_report.md");
+        
+    } else if (mode == "buildfreq") {
+        // Frequency file from a text corpus
+        if (!countCorpusWords(targetFile, frequencyOutput)) {
+            return 1;
+        }
+        cout << "Wrote " << frequencyOutput << "\n";
     }
     
     return 0;
@@ -18,6 +18,7 @@ ParallelSpellChecker::ParallelSpellChecker(SpellChecker* sc, int threads)
     } else {
         numThreads = threads;
     }
+    contexts.resize(numThreads);
     
     #ifdef _OPENMP
     omp_set_num_threads(numThreads);
@@ -27,6 +28,7 @@ ParallelSpellChecker::ParallelSpellChecker(SpellChecker* sc, int threads)
 // Set thread count
 void ParallelSpellChecker::setThreadCount(int threads) {
     numThreads = threads > 0 ? threads : 4;
+    contexts.resize(numThreads);
     #ifdef _OPENMP
     omp_set_num_threads(numThreads);
     #endif
@@ -58,6 +60,7 @@ SpellCheckResult ParallelSpellChecker::checkTextParallel(const string& text, con
     
     vector<string> words = tokenize(text);
     int totalWords = words.size();
+    SuggestionEngine& engine = checker->getEngine(method);
     
     // Thread-local storage for errors
     vector<vector<SpellingError>> threadErrors(numThreads);
@@ -79,15 +82,10 @@ SpellCheckResult ParallelSpellChecker::checkTextParallel(const string& text, con
                 error.originalWord = word;
                 error.lineNumber = 1;  // Simplified
                 error.position = i;
-                error.method = method;
-                
-                // Get suggestions based on method
-                if (method == "trie") {
-                    error.suggestions = checker->getSuggestionsTrie(word);
-                } else if (method == "kdtree") {
-                    error.suggestions = checker->getSuggestionsKDTree(word);
-                } else {
-                    error.suggestions = checker->getSuggestionsAStar(word);
+                error.method = engine.name();
+                error.suggestions = engine.suggest(word, contexts[tid]);
+                if (checker->getPhoneticMerge()) {
+                    checker->mergePhoneticCandidates(word, error.suggestions);
                 }
                 
                 threadErrors[tid].push_back(error);
@@ -106,14 +104,10 @@ SpellCheckResult ParallelSpellChecker::checkTextParallel(const string& text, con
             error.originalWord = word;
             error.lineNumber = 1;
             error.position = i;
-            error.method = method;
-            
-            if (method == "trie") {
-                error.suggestions = checker->getSuggestionsTrie(word);
-            } else if (method == "kdtree") {
-                error.suggestions = checker->getSuggestionsKDTree(word);
-            } else {
-                error.suggestions = checker->getSuggestionsAStar(word);
+            error.method = engine.name();
+            error.suggestions = engine.suggest(word, contexts[0]);
+            if (checker->getPhoneticMerge()) {
+                checker->mergePhoneticCandidates(word, error.suggestions);
             }
             
             threadErrors[0].push_back(error);
@@ -160,22 +154,7 @@ SpellCheckResult ParallelSpellChecker::checkFileParallel(const string& filename,
 
 // Get suggestions for multiple words in parallel
 vector<vector<string>> ParallelSpellChecker::getSuggestionsParallel(const vector<string>& words, const string& method) {
-    vector<vector<string>> allSuggestions(words.size());
-    
-    #ifdef _OPENMP
-    #pragma omp parallel for num_threads(numThreads) schedule(dynamic)
-    #endif
-    for (size_t i = 0; i < words.size(); i++) {
-        if (method == "trie") {
-            allSuggestions[i] = checker->getSuggestionsTrie(words[i]);
-        } else if (method == "kdtree") {
-            allSuggestions[i] = checker->getSuggestionsKDTree(words[i]);
-        } else {
-            allSuggestions[i] = checker->getSuggestionsAStar(words[i]);
-        }
-    }
-    
-    return allSuggestions;
+    return checker->getEngine(method).suggestBatch(words, contexts);
 }
 
 // Compare sequential vs parallel performance
@@ -206,7 +185,7 @@ void ParallelSpellChecker::compareSequentialVsParallel(const string& text) {
         if (checker->isValidWord(word)) {
             seqCorrect++;
         } else {
-            checker->getSuggestionsAStar(word);  // Use A* as default
+            checker->getSuggestionsAStar(word, contexts[0]);  // Use A* as default
             seqErrors++;
         }
     }
@@ -0,0 +1,513 @@
+#include "../include/phonetic.h"
+#include <algorithm>
+#include <cctype>
+#include <initializer_list>
+
+namespace {
+
+// Straight port of the published rule set. Positions past the word read as
+// spaces, which the rules use to test for the end of a word.
+class MetaphoneEncoder {
+private:
+    string w;
+    int length;
+    int last;
+    string primary;
+    string alternate;
+
+    char at(int i) const {
+        return (i >= 0 && i < static_cast<int>(w.size())) ? w[i] : '\0';
+    }
+
+    bool isVowel(int i) const {
+        char c = at(i);
+        return c == 'A' || c == 'E' || c == 'I' || c == 'O' || c == 'U' || c == 'Y';
+    }
+
+    bool stringAt(int start, int len, initializer_list<const char*> options) const {
+        if (start < 0 || start + len > static_cast<int>(w.size())) return false;
+        for (const char* option : options) {
+            if (w.compare(start, len, option) == 0) return true;
+        }
+        return false;
+    }
+
+    bool slavoGermanic() const {
+        return w.find('W') != string::npos || w.find('K') != string::npos ||
+               w.find("CZ") != string::npos || w.find("WITZ") != string::npos;
+    }
+
+    void add(const char* main) {
+        primary += main;
+        alternate += main;
+    }
+
+    void add(const char* main, const char* alt) {
+        primary += main;
+        alternate += alt;
+    }
+
+    int encodeC(int current);
+    int encodeG(int current);
+    int encodeS(int current);
+    int encodeOther(int current);
+
+public:
+    explicit MetaphoneEncoder(const string& word);
+    PhoneticCode encode(size_t maxLength);
+};
+
+MetaphoneEncoder::MetaphoneEncoder(const string& word) {
+    for (char c : word) {
+        if (isalpha(static_cast<unsigned char>(c))) {
+            w += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    length = w.size();
+    last = length - 1;
+    w += "     ";
+}
+
+int MetaphoneEncoder::encodeC(int current) {
+    // Various Germanic: "bacher", "macher"
+    if (current > 1 && !isVowel(current - 2) && stringAt(current - 1, 3, {"ACH"}) && at(current + 2) != 'I' &&
+        (at(current + 2) != 'E' || stringAt(current - 2, 6, {"BACHER", "MACHER"}))) {
+        add("K");
+        return current + 2;
+    }
+    if (current == 0 && stringAt(current, 6, {"CAESAR"})) {
+        add("S");
+        return current + 2;
+    }
+    if (stringAt(current, 4, {"CHIA"})) {
+        add("K");
+        return current + 2;
+    }
+    if (stringAt(current, 2, {"CH"})) {
+        if (current > 0 && stringAt(current, 4, {"CHAE"})) {
+            add("K", "X");
+            return current + 2;
+        }
+        // Greek roots: "chemistry", "chorus"
+        if (current == 0 && (stringAt(current + 1, 5, {"HARAC", "HARIS"}) ||
+                             stringAt(current + 1, 3, {"HOR", "HYM", "HIA", "HEM"})) &&
+            !stringAt(0, 5, {"CHORE"})) {
+            add("K");
+            return current + 2;
+        }
+        if (stringAt(0, 4, {"VAN ", "VON "}) || stringAt(0, 3, {"SCH"}) ||
+            stringAt(current - 2, 6, {"ORCHES", "ARCHIT", "ORCHID"}) || stringAt(current + 2, 1, {"T", "S"}) ||
+            ((stringAt(current - 1, 1, {"A", "O", "U", "E"}) || current == 0) &&
+             stringAt(current + 2, 1, {"L", "R", "N", "M", "B", "H", "F", "V", "W", " "}))) {
+            add("K");
+        } else if (current > 0) {
+            if (stringAt(0, 2, {"MC"})) add("K");
+            else add("X", "K");
+        } else {
+            add("X");
+        }
+        return current + 2;
+    }
+    if (stringAt(current, 2, {"CZ"}) && !stringAt(current - 2, 4, {"WICZ"})) {
+        add("S", "X");
+        return current + 2;
+    }
+    if (stringAt(current + 1, 3, {"CIA"})) {
+        add("X");
+        return current + 3;
+    }
+    // Double C, but not "McClellan"
+    if (stringAt(current, 2, {"CC"}) && !(current == 1 && at(0) == 'M')) {
+        if (stringAt(current + 2, 1, {"I", "E", "H"}) && !stringAt(current + 2, 2, {"HU"})) {
+            if ((current == 1 && at(current - 1) == 'A') || stringAt(current - 1, 5, {"UCCEE", "UCCES"})) {
+                add("KS");
+            } else {
+                add("X");
+            }
+            return current + 3;
+        }
+        add("K");
+        return current + 2;
+    }
+    if (stringAt(current, 2, {"CK", "CG", "CQ"})) {
+        add("K");
+        return current + 2;
+    }
+    if (stringAt(current, 2, {"CI", "CE", "CY"})) {
+        if (stringAt(current, 3, {"CIO", "CIE", "CIA"})) add("S", "X");
+        else add("S");
+        return current + 2;
+    }
+
+    add("K");
+    if (stringAt(current + 1, 2, {" C", " Q", " G"})) return current + 3;
+    if (stringAt(current + 1, 1, {"C", "K", "Q"}) && !stringAt(current + 1, 2, {"CE", "CI"})) return current + 2;
+    return current + 1;
+}
+
+int MetaphoneEncoder::encodeG(int current) {
+    if (at(current + 1) == 'H') {
+        if (current > 0 && !isVowel(current - 1)) {
+            add("K");
+            return current + 2;
+        }
+        if (current == 0) {
+            add(at(current + 2) == 'I' ? "J" : "K");
+            return current + 2;
+        }
+        // Silent: "hugh", "bough", "broughton"
+        if ((current > 1 && stringAt(current - 2, 1, {"B", "H", "D"})) ||
+            (current > 2 && stringAt(current - 3, 1, {"B", "H", "D"})) ||
+            (current > 3 && stringAt(current - 4, 1, {"B", "H"}))) {
+            return current + 2;
+        }
+        // "laugh", "cough", "rough"
+        if (current > 2 && at(current - 1) == 'U' && stringAt(current - 3, 1, {"C", "G", "L", "R", "T"})) {
+            add("F");
+        } else if (current > 0 && at(current - 1) != 'I') {
+            add("K");
+        }
+        return current + 2;
+    }
+    if (at(current + 1) == 'N') {
+        if (current == 1 && isVowel(0) && !slavoGermanic()) {
+            add("KN", "N");
+        } else if (!stringAt(current + 2, 2, {"EY"}) && at(current + 1) != 'Y' && !slavoGermanic()) {
+            add("N", "KN");
+        } else {
+            add("KN");
+        }
+        return current + 2;
+    }
+    if (stringAt(current + 1, 2, {"LI"}) && !slavoGermanic()) {
+        add("KL", "L");
+        return current + 2;
+    }
+    if (current == 0 && (at(current + 1) == 'Y' ||
+                         stringAt(current + 1, 2, {"ES", "EP", "EB", "EL", "EY", "IB", "IL", "IN", "IE", "EI", "ER"}))) {
+        add("K", "J");
+        return current + 2;
+    }
+    if ((stringAt(current + 1, 2, {"ER"}) || at(current + 1) == 'Y') &&
+        !stringAt(0, 6, {"DANGER", "RANGER", "MANGER"}) && !stringAt(current - 1, 1, {"E", "I"}) &&
+        !stringAt(current - 1, 3, {"RGY", "OGY"})) {
+        add("K", "J");
+        return current + 2;
+    }
+    if (stringAt(current + 1, 1, {"E", "I", "Y"}) || stringAt(current - 1, 4, {"AGGI", "OGGI"})) {
+        if (stringAt(0, 4, {"VAN ", "VON "}) || stringAt(0, 3, {"SCH"}) || stringAt(current + 1, 2, {"ET"})) {
+            add("K");
+        } else if (stringAt(current + 1, 4, {"IER "})) {
+            add("J");
+        } else {
+            add("J", "K");
+        }
+        return current + 2;
+    }
+
+    add("K");
+    return current + (at(current + 1) == 'G' ? 2 : 1);
+}
+
+int MetaphoneEncoder::encodeS(int current) {
+    // Silent: "island", "carlisle"
+    if (stringAt(current - 1, 3, {"ISL", "YSL"})) {
+        return current + 1;
+    }
+    if (current == 0 && stringAt(current, 5, {"SUGAR"})) {
+        add("X", "S");
+        return current + 1;
+    }
+    if (stringAt(current, 2, {"SH"})) {
+        if (stringAt(current + 1, 4, {"HEIM", "HOEK", "HOLM", "HOLZ"})) add("S");
+        else add("X");
+        return current + 2;
+    }
+    if (stringAt(current, 3, {"SIO", "SIA"}) || stringAt(current, 4, {"SIAN"})) {
+        if (!slavoGermanic()) add("S", "X");
+        else add("S");
+        return current + 3;
+    }
+    if ((current == 0 && stringAt(current + 1, 1, {"M", "N", "L", "W"})) || stringAt(current + 1, 1, {"Z"})) {
+        add("S", "X");
+        return current + (stringAt(current + 1, 1, {"Z"}) ? 2 : 1);
+    }
+    if (stringAt(current, 2, {"SC"})) {
+        if (at(current + 2) == 'H') {
+            if (stringAt(current + 3, 2, {"OO", "ER", "EN", "UY", "ED", "EM"})) {
+                if (stringAt(current + 3, 2, {"ER", "EN"})) add("X", "SK");
+                else add("SK");
+                return current + 3;
+            }
+            if (current == 0 && !isVowel(3) && at(3) != 'W') add("X", "S");
+            else add("X");
+            return current + 3;
+        }
+        if (stringAt(current + 2, 1, {"I", "E", "Y"})) {
+            add("S");
+            return current + 3;
+        }
+        add("SK");
+        return current + 3;
+    }
+
+    // French endings: "resnais", "artois"
+    if (current == last && stringAt(current - 2, 2, {"AI", "OI"})) add("", "S");
+    else add("S");
+    return current + (stringAt(current + 1, 1, {"S", "Z"}) ? 2 : 1);
+}
+
+int MetaphoneEncoder::encodeOther(int current) {
+    char c = at(current);
+    char next = at(current + 1);
+
+    switch (c) {
+        case 'A': case 'E': case 'I': case 'O': case 'U': case 'Y':
+            // Vowels only count at the start of a word
+            if (current == 0) add("A");
+            return current + 1;
+
+        case 'B':
+            add("P");
+            return current + (next == 'B' ? 2 : 1);
+
+        case 'D':
+            if (stringAt(current, 2, {"DG"})) {
+                if (stringAt(current + 2, 1, {"I", "E", "Y"})) {
+                    add("J");
+                    return current + 3;
+                }
+                add("TK");
+                return current + 2;
+            }
+            add("T");
+            return current + (stringAt(current, 2, {"DT", "DD"}) ? 2 : 1);
+
+        case 'F':
+            add("F");
+            return current + (next == 'F' ? 2 : 1);
+
+        case 'H':
+            // Only sounded between vowels or at the start before a vowel
+            if ((current == 0 || isVowel(current - 1)) && isVowel(current + 1)) {
+                add("H");
+                return current + 2;
+            }
+            return current + 1;
+
+        case 'J':
+            if (stringAt(current, 4, {"JOSE"}) || stringAt(0, 4, {"SAN "})) {
+                if ((current == 0 && at(current + 4) == ' ') || stringAt(0, 4, {"SAN "})) add("H");
+                else add("J", "H");
+                return current + 1;
+            }
+            if (current == 0) {
+                add("J", "A");
+            } else if (isVowel(current - 1) && !slavoGermanic() && (next == 'A' || next == 'O')) {
+                add("J", "H");
+            } else if (current == last) {
+                add("J", "");
+            } else if (!stringAt(current + 1, 1, {"L", "T", "K", "S", "N", "M", "B", "Z"}) &&
+                       !stringAt(current - 1, 1, {"S", "K", "L"})) {
+                add("J");
+            }
+            return current + (next == 'J' ? 2 : 1);
+
+        case 'K':
+            add("K");
+            return current + (next == 'K' ? 2 : 1);
+
+        case 'L':
+            if (next == 'L') {
+                // Spanish: "cabrillo", "gallegos"
+                if ((current == length - 3 && stringAt(current - 1, 4, {"ILLO", "ILLA", "ALLE"})) ||
+                    ((stringAt(last - 1, 2, {"AS", "OS"}) || stringAt(last, 1, {"A", "O"})) &&
+                     stringAt(current - 1, 4, {"ALLE"}))) {
+                    add("L", "");
+                    return current + 2;
+                }
+                add("L");
+                return current + 2;
+            }
+            add("L");
+            return current + 1;
+
+        case 'M':
+            add("M");
+            // "dumb", "thumb"
+            if ((stringAt(current - 1, 3, {"UMB"}) && (current + 1 == last || stringAt(current + 2, 2, {"ER"}))) ||
+                next == 'M') {
+                return current + 2;
+            }
+            return current + 1;
+
+        case 'N':
+            add("N");
+            return current + (next == 'N' ? 2 : 1);
+
+        case 'P':
+            if (next == 'H') {
+                add("F");
+                return current + 2;
+            }
+            add("P");
+            return current + (stringAt(current + 1, 1, {"P", "B"}) ? 2 : 1);
+
+        case 'Q':
+            add("K");
+            return current + (next == 'Q' ? 2 : 1);
+
+        case 'R':
+            // French: "rogier"
+            if (current == last && !slavoGermanic() && stringAt(current - 2, 2, {"IE"}) &&
+                !stringAt(current - 4, 2, {"ME", "MA"})) {
+                add("", "R");
+            } else {
+                add("R");
+            }
+            return current + (next == 'R' ? 2 : 1);
+
+        case 'T':
+            if (stringAt(current, 4, {"TION"}) || stringAt(current, 3, {"TIA", "TCH"})) {
+                add("X");
+                return current + 3;
+            }
+            if (stringAt(current, 2, {"TH"}) || stringAt(current, 3, {"TTH"})) {
+                if (stringAt(current + 2, 2, {"OM", "AM"}) || stringAt(0, 4, {"VAN ", "VON "}) || stringAt(0, 3, {"SCH"})) {
+                    add("T");
+                } else {
+                    add("0", "T");
+                }
+                return current + 2;
+            }
+            add("T");
+            return current + (stringAt(current + 1, 1, {"T", "D"}) ? 2 : 1);
+
+        case 'V':
+            add("F");
+            return current + (next == 'V' ? 2 : 1);
+
+        case 'W':
+            if (stringAt(current, 2, {"WR"})) {
+                add("R");
+                return current + 2;
+            }
+            if (current == 0 && (isVowel(current + 1) || stringAt(current, 2, {"WH"}))) {
+                if (isVowel(current + 1)) add("A", "F");
+                else add("A");
+            }
+            // Polish: "filipowicz"
+            if ((current == last && isVowel(current - 1)) ||
+                stringAt(current - 1, 5, {"EWSKI", "EWSKY", "OWSKI", "OWSKY"}) || stringAt(0, 3, {"SCH"})) {
+                add("", "F");
+                return current + 1;
+            }
+            if (stringAt(current, 4, {"WICZ", "WITZ"})) {
+                add("TS", "FX");
+                return current + 4;
+            }
+            return current + 1;
+
+        case 'X':
+            // French: "breaux"
+            if (!(current == last && (stringAt(current - 3, 3, {"IAU", "EAU"}) || stringAt(current - 2, 2, {"AU", "OU"})))) {
+                add("KS");
+            }
+            return current + (stringAt(current + 1, 1, {"C", "X"}) ? 2 : 1);
+
+        case 'Z':
+            if (next == 'H') {
+                add("J");
+                return current + 2;
+            }
+            if (stringAt(current + 1, 2, {"ZO", "ZI", "ZA"}) || (slavoGermanic() && current > 0 && at(current - 1) != 'T')) {
+                add("S", "TS");
+            } else {
+                add("S");
+            }
+            return current + (next == 'Z' ? 2 : 1);
+
+        default:
+            return current + 1;
+    }
+}
+
+PhoneticCode MetaphoneEncoder::encode(size_t maxLength) {
+    int current = 0;
+
+    // Silent first letters: "gnome", "knight", "pneumatic", "wrack", "psalm"
+    if (stringAt(0, 2, {"GN", "KN", "PN", "WR", "PS"})) current++;
+    // "Xavier"
+    if (at(0) == 'X') {
+        add("S");
+        current++;
+    }
+
+    while ((primary.size() < maxLength || alternate.size() < maxLength) && current < length) {
+        switch (at(current)) {
+            case 'C': current = encodeC(current); break;
+            case 'G': current = encodeG(current); break;
+            case 'S': current = encodeS(current); break;
+            default:  current = encodeOther(current); break;
+        }
+    }
+
+    if (primary.size() > maxLength) primary.resize(maxLength);
+    if (alternate.size() > maxLength) alternate.resize(maxLength);
+    return PhoneticCode{primary, alternate};
+}
+
+} // namespace
+
+PhoneticCode doubleMetaphone(const string& word, size_t maxLength) {
+    MetaphoneEncoder encoder(word);
+    return encoder.encode(maxLength);
+}
+
+// PhoneticIndex
+
+uint32_t PhoneticIndex::pack(const string& code) {
+    // Codes are at most four ASCII letters or digits: one byte each
+    uint32_t key = 0;
+    for (size_t i = 0; i < code.size() && i < 4; i++) {
+        key = (key << 8) | static_cast<unsigned char>(code[i]);
+    }
+    return key;
+}
+
+void PhoneticIndex::build(const vector<string>& words) {
+    vector<pair<uint32_t, int>> entries;
+    entries.reserve(words.size() * 2);
+    for (size_t id = 0; id < words.size(); id++) {
+        PhoneticCode code = doubleMetaphone(words[id]);
+        if (!code.primary.empty()) entries.push_back({pack(code.primary), static_cast<int>(id)});
+        if (!code.alternate.empty() && code.alternate != code.primary) {
+            entries.push_back({pack(code.alternate), static_cast<int>(id)});
+        }
+    }
+    sort(entries.begin(), entries.end());
+
+    keys.clear();
+    ids.clear();
+    for (const auto& [key, id] : entries) {
+        keys.push_back(key);
+        ids.push_back(id);
+    }
+}
+
+void PhoneticIndex::lookup(const string& query, vector<int>& result) const {
+    result.clear();
+    PhoneticCode code = doubleMetaphone(query);
+
+    for (const string* c : {&code.primary, &code.alternate}) {
+        if (c->empty() || (c == &code.alternate && code.alternate == code.primary)) continue;
+        uint32_t key = pack(*c);
+        auto range = equal_range(keys.begin(), keys.end(), key);
+        for (auto it = range.first; it != range.second; ++it) {
+            result.push_back(ids[it - keys.begin()]);
+        }
+    }
+
+    sort(result.begin(), result.end());
+    result.erase(unique(result.begin(), result.end()), result.end());
+}
@@ -0,0 +1,149 @@
+#include "../include/qgram_index.h"
+#include <algorithm>
+#include <tuple>
+#include <cstdlib>
+
+namespace {
+
+void writeVarint(vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t readVarint(const uint8_t*& in) {
+    uint32_t value = 0;
+    int shift = 0;
+    while (*in & 0x80) {
+        value |= static_cast<uint32_t>(*in++ & 0x7f) << shift;
+        shift += 7;
+    }
+    value |= static_cast<uint32_t>(*in++) << shift;
+    return value;
+}
+
+// 0 is the boundary pad; letters are 1..26, anything else pads too
+int symbolOf(char c) {
+    unsigned letter = static_cast<unsigned char>(c) - 'a';
+    return letter < 26 ? static_cast<int>(letter) + 1 : 0;
+}
+
+} // namespace
+
+QGramIndex::QGramIndex(int qLength) : q(max(1, min(qLength, 3))), gramCount(1), postingCount(0) {
+    for (int i = 0; i < q; i++) gramCount *= 27;
+    offsets.assign(gramCount + 1, 0);
+}
+
+void QGramIndex::gramsOf(const string& word, vector<int>& grams) const {
+    // Sorted codes of the padded word's grams, repeats kept
+    grams.clear();
+    int padded = word.length() + 2 * (q - 1);
+    for (int start = 0; start + q <= padded; start++) {
+        int code = 0;
+        for (int i = start; i < start + q; i++) {
+            int pos = i - (q - 1);
+            int symbol = (pos >= 0 && pos < static_cast<int>(word.length())) ? symbolOf(word[pos]) : 0;
+            code = code * 27 + symbol;
+        }
+        grams.push_back(code);
+    }
+    sort(grams.begin(), grams.end());
+}
+
+void QGramIndex::build(const vector<string>& words) {
+    // (gram, word id, multiplicity), sorted by gram then id
+    vector<tuple<int, int, int>> entries;
+    vector<int> grams;
+    lengths.resize(words.size());
+    for (size_t id = 0; id < words.size(); id++) {
+        lengths[id] = static_cast<uint8_t>(min<size_t>(words[id].length(), 255));
+        gramsOf(words[id], grams);
+        for (size_t i = 0; i < grams.size();) {
+            size_t j = i;
+            while (j < grams.size() && grams[j] == grams[i]) j++;
+            entries.emplace_back(grams[i], static_cast<int>(id), static_cast<int>(j - i));
+            i = j;
+        }
+    }
+    sort(entries.begin(), entries.end());
+    postingCount = entries.size();
+
+    postings.clear();
+    offsets.assign(gramCount + 1, 0);
+    size_t e = 0;
+    for (int gram = 0; gram < gramCount; gram++) {
+        offsets[gram] = postings.size();
+        int previous = 0;
+        for (; e < entries.size() && get<0>(entries[e]) == gram; e++) {
+            int id = get<1>(entries[e]);
+            int multiplicity = get<2>(entries[e]);
+            uint32_t delta = static_cast<uint32_t>(id - previous);
+            writeVarint(postings, (delta << 1) | (multiplicity > 1 ? 1 : 0));
+            if (multiplicity > 1) writeVarint(postings, multiplicity);
+            previous = id;
+        }
+    }
+    offsets[gramCount] = postings.size();
+    postings.shrink_to_fit();
+}
+
+void QGramIndex::lookup(const string& query, int maxDist, vector<int>& ids, LookupContext& context) const {
+    ids.clear();
+    if (context.shared.size() < lengths.size()) {
+        context.shared.assign(lengths.size(), 0);
+    }
+    context.touched.clear();
+
+    // Count shared grams, multiset intersection: min of both multiplicities
+    gramsOf(query, context.grams);
+    const vector<int>& grams = context.grams;
+    for (size_t i = 0; i < grams.size();) {
+        size_t j = i;
+        while (j < grams.size() && grams[j] == grams[i]) j++;
+        int queryMultiplicity = j - i;
+
+        const uint8_t* in = postings.data() + offsets[grams[i]];
+        const uint8_t* end = postings.data() + offsets[grams[i] + 1];
+        int id = 0;
+        while (in < end) {
+            uint32_t word = readVarint(in);
+            id += word >> 1;
+            int multiplicity = (word & 1) ? readVarint(in) : 1;
+            if (context.shared[id] == 0) context.touched.push_back(id);
+            context.shared[id] += min(queryMultiplicity, multiplicity);
+        }
+        i = j;
+    }
+
+    int queryLength = min<size_t>(query.length(), 255);
+    auto passes = [&](int id) {
+        int length = lengths[id];
+        if (abs(length - queryLength) > maxDist) return false;
+        int needed = max(length, queryLength) + q - 1 - q * maxDist;
+        return static_cast<int>(context.shared[id]) >= needed;
+    };
+
+    // A short query against short words may need no shared gram at all;
+    // then words the postings never touched can pass as well
+    if (queryLength + q - 1 - q * maxDist <= 0) {
+        for (size_t id = 0; id < lengths.size(); id++) {
+            if (passes(id)) ids.push_back(id);
+        }
+    } else {
+        for (int id : context.touched) {
+            if (passes(id)) ids.push_back(id);
+        }
+        sort(ids.begin(), ids.end());
+    }
+
+    for (int id : context.touched) {
+        context.shared[id] = 0;
+    }
+}
+
+size_t QGramIndex::memoryBytes() const {
+    return postings.capacity() + offsets.capacity() * sizeof(uint32_t) + lengths.capacity();
+}
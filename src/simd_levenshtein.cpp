@@ -0,0 +1,409 @@
+#include "../include/simd_levenshtein.h"
+#include <algorithm>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_LEVENSHTEIN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Extra lanes past the end of every buffer, so full-width loads and stores
+// at the tail of a diagonal stay inside the allocation
+const int kPadding = 32;
+
+// Below this length a diagonal fills too few lanes to pay for the setup, and
+// the scalar kernel wins (see Benchmark::benchmarkLevenshteinKernels)
+const int kSimdMinLength = 12;
+
+// Computes cells start..end of one anti-diagonal. Cell i compares s1[i - 1]
+// with the reversed s2 at bOffset + i, which makes both loads contiguous.
+template<typename Lane>
+using InteriorFn = void (*)(Lane* cur, const Lane* prev1, const Lane* prev2,
+                            const char* a, const char* b, int bOffset, int start, int end);
+
+#ifdef SIMD_LEVENSHTEIN_X86
+
+__attribute__((target("avx2")))
+void interiorAVX2U8(uint8_t* cur, const uint8_t* prev1, const uint8_t* prev2,
+                    const char* a, const char* b, int bOffset, int start, int end) {
+    const __m256i one = _mm256_set1_epi8(1);
+    for (int i = start; i <= end; i += 32) {
+        __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev1 + i - 1));
+        __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev1 + i));
+        __m256i diag = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev2 + i - 1));
+        __m256i ca = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 1));
+        __m256i cb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + bOffset + i));
+        __m256i cost = _mm256_andnot_si256(_mm256_cmpeq_epi8(ca, cb), one);
+        __m256i best = _mm256_min_epu8(_mm256_adds_epu8(_mm256_min_epu8(up, left), one),
+                                       _mm256_adds_epu8(diag, cost));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(cur + i), best);
+    }
+}
+
+__attribute__((target("avx2")))
+void interiorAVX2U16(uint16_t* cur, const uint16_t* prev1, const uint16_t* prev2,
+                     const char* a, const char* b, int bOffset, int start, int end) {
+    const __m256i one = _mm256_set1_epi16(1);
+    for (int i = start; i <= end; i += 16) {
+        __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev1 + i - 1));
+        __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev1 + i));
+        __m256i diag = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev2 + i - 1));
+        __m256i ca = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i - 1)));
+        __m256i cb = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + bOffset + i)));
+        __m256i cost = _mm256_andnot_si256(_mm256_cmpeq_epi16(ca, cb), one);
+        __m256i best = _mm256_min_epu16(_mm256_adds_epu16(_mm256_min_epu16(up, left), one),
+                                        _mm256_adds_epu16(diag, cost));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(cur + i), best);
+    }
+}
+
+__attribute__((target("sse4.1")))
+void interiorSSE41U8(uint8_t* cur, const uint8_t* prev1, const uint8_t* prev2,
+                     const char* a, const char* b, int bOffset, int start, int end) {
+    const __m128i one = _mm_set1_epi8(1);
+    for (int i = start; i <= end; i += 16) {
+        __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev1 + i - 1));
+        __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev1 + i));
+        __m128i diag = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev2 + i - 1));
+        __m128i ca = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i - 1));
+        __m128i cb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + bOffset + i));
+        __m128i cost = _mm_andnot_si128(_mm_cmpeq_epi8(ca, cb), one);
+        __m128i best = _mm_min_epu8(_mm_adds_epu8(_mm_min_epu8(up, left), one),
+                                    _mm_adds_epu8(diag, cost));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(cur + i), best);
+    }
+}
+
+__attribute__((target("sse4.1")))
+void interiorSSE41U16(uint16_t* cur, const uint16_t* prev1, const uint16_t* prev2,
+                      const char* a, const char* b, int bOffset, int start, int end) {
+    const __m128i one = _mm_set1_epi16(1);
+    for (int i = start; i <= end; i += 8) {
+        __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev1 + i - 1));
+        __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev1 + i));
+        __m128i diag = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev2 + i - 1));
+        __m128i ca = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + i - 1)));
+        __m128i cb = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + bOffset + i)));
+        __m128i cost = _mm_andnot_si128(_mm_cmpeq_epi16(ca, cb), one);
+        __m128i best = _mm_min_epu16(_mm_adds_epu16(_mm_min_epu16(up, left), one),
+                                     _mm_adds_epu16(diag, cost));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(cur + i), best);
+    }
+}
+
+#endif // SIMD_LEVENSHTEIN_X86
+
+// Walks the anti-diagonals k = 2 .. m + n, keeping the last three in a ring
+template<typename Lane>
+int runDiagonals(const string& s1, const string& s2, vector<Lane>& diagonals,
+                 LevenshteinScratch& scratch, InteriorFn<Lane> interior) {
+    int m = s1.length();
+    int n = s2.length();
+
+    size_t width = m + 1 + kPadding;
+    if (diagonals.size() < 3 * width) diagonals.resize(3 * width);
+    if (scratch.s1Padded.size() < static_cast<size_t>(m + kPadding)) scratch.s1Padded.resize(m + kPadding);
+    if (scratch.s2Reversed.size() < static_cast<size_t>(n + kPadding)) scratch.s2Reversed.resize(n + kPadding);
+
+    // Pad with different bytes so the (ignored) tail lanes never match
+    char* a = scratch.s1Padded.data();
+    char* b = scratch.s2Reversed.data();
+    copy(s1.begin(), s1.end(), a);
+    fill(a + m, a + m + kPadding, '\0');
+    reverse_copy(s2.begin(), s2.end(), b);
+    fill(b + n, b + n + kPadding, '\1');
+
+    Lane* ring[3] = {diagonals.data(), diagonals.data() + width, diagonals.data() + 2 * width};
+    ring[0][0] = 0;  // dp[0][0]
+    ring[1][0] = 1;  // dp[0][1]
+    ring[1][1] = 1;  // dp[1][0]
+
+    for (int k = 2; k <= m + n; k++) {
+        Lane* cur = ring[k % 3];
+        const Lane* prev1 = ring[(k - 1) % 3];
+        const Lane* prev2 = ring[(k - 2) % 3];
+
+        int start = max(1, k - n);
+        int end = min(m, k - 1);
+        if (start <= end) {
+            interior(cur, prev1, prev2, a, b, n - k, start, end);
+        }
+
+        // Boundary cells go in last: vector stores may run past the interior
+        if (k <= n) cur[0] = static_cast<Lane>(k);
+        if (k <= m) cur[k] = static_cast<Lane>(k);
+    }
+
+    return ring[(m + n) % 3][m];
+}
+
+// Plain two-row DP, used as the scalar kernel and for very long inputs
+int twoRowLevenshtein(const string& s1, const string& s2, LevenshteinScratch& scratch) {
+    int m = s1.length();
+    int n = s2.length();
+
+    if (scratch.rows.size() < static_cast<size_t>(2 * (n + 1))) scratch.rows.resize(2 * (n + 1));
+    int* prev = scratch.rows.data();
+    int* curr = prev + n + 1;
+    for (int j = 0; j <= n; j++) prev[j] = j;
+
+    for (int i = 1; i <= m; i++) {
+        curr[0] = i;
+        for (int j = 1; j <= n; j++) {
+            int cost = s1[i - 1] != s2[j - 1] ? 1 : 0;
+            curr[j] = min({prev[j] + 1, curr[j - 1] + 1, prev[j - 1] + cost});
+        }
+        swap(prev, curr);
+    }
+
+    return prev[n];
+}
+
+#ifdef SIMD_LEVENSHTEIN_X86
+
+// One-vs-many rows: lane l of every vector belongs to candidate l, and the
+// target character of the current row is broadcast to all lanes. Returns
+// false as soon as every lane's row minimum exceeds the bound.
+__attribute__((target("avx2")))
+bool batchRowsAVX2(const uint8_t* columns, int maxLen, const string& target, uint8_t* rows, int bound) {
+    const int lanes = 32;
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(bound < 0 ? 255 : bound));
+
+    for (int j = 0; j <= maxLen; j++) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rows + j * lanes), _mm256_set1_epi8(static_cast<char>(j)));
+    }
+
+    for (size_t i = 1; i <= target.length(); i++) {
+        __m256i ch = _mm256_set1_epi8(target[i - 1]);
+        __m256i diag = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows));
+        __m256i left = _mm256_set1_epi8(static_cast<char>(i));
+        __m256i rowMin = left;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rows), left);
+
+        for (int j = 1; j <= maxLen; j++) {
+            __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + j * lanes));
+            __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns + (j - 1) * lanes));
+            __m256i cost = _mm256_andnot_si256(_mm256_cmpeq_epi8(chars, ch), one);
+            __m256i cell = _mm256_min_epu8(_mm256_adds_epu8(_mm256_min_epu8(up, left), one),
+                                           _mm256_adds_epu8(diag, cost));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rows + j * lanes), cell);
+            diag = up;
+            left = cell;
+            rowMin = _mm256_min_epu8(rowMin, cell);
+        }
+
+        if (bound >= 0) {
+            __m256i within = _mm256_cmpeq_epi8(_mm256_subs_epu8(rowMin, limit), zero);
+            if (_mm256_movemask_epi8(within) == 0) return false;
+        }
+    }
+    return true;
+}
+
+__attribute__((target("sse4.1")))
+bool batchRowsSSE41(const uint8_t* columns, int maxLen, const string& target, uint8_t* rows, int bound) {
+    const int lanes = 16;
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(bound < 0 ? 255 : bound));
+
+    for (int j = 0; j <= maxLen; j++) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rows + j * lanes), _mm_set1_epi8(static_cast<char>(j)));
+    }
+
+    for (size_t i = 1; i <= target.length(); i++) {
+        __m128i ch = _mm_set1_epi8(target[i - 1]);
+        __m128i diag = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows));
+        __m128i left = _mm_set1_epi8(static_cast<char>(i));
+        __m128i rowMin = left;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rows), left);
+
+        for (int j = 1; j <= maxLen; j++) {
+            __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + j * lanes));
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns + (j - 1) * lanes));
+            __m128i cost = _mm_andnot_si128(_mm_cmpeq_epi8(chars, ch), one);
+            __m128i cell = _mm_min_epu8(_mm_adds_epu8(_mm_min_epu8(up, left), one),
+                                        _mm_adds_epu8(diag, cost));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rows + j * lanes), cell);
+            diag = up;
+            left = cell;
+            rowMin = _mm_min_epu8(rowMin, cell);
+        }
+
+        if (bound >= 0) {
+            __m128i within = _mm_cmpeq_epi8(_mm_subs_epu8(rowMin, limit), zero);
+            if (_mm_movemask_epi8(within) == 0) return false;
+        }
+    }
+    return true;
+}
+
+#endif // SIMD_LEVENSHTEIN_X86
+
+LevenshteinKernel detectKernel() {
+#ifdef SIMD_LEVENSHTEIN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return LevenshteinKernel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return LevenshteinKernel::SSE41;
+#endif
+    return LevenshteinKernel::Scalar;
+}
+
+const LevenshteinKernel startupKernel = detectKernel();
+
+} // namespace
+
+LevenshteinKernel activeLevenshteinKernel() {
+    return startupKernel;
+}
+
+bool levenshteinKernelSupported(LevenshteinKernel kernel) {
+    switch (kernel) {
+        case LevenshteinKernel::AVX2:
+            return startupKernel == LevenshteinKernel::AVX2;
+        case LevenshteinKernel::SSE41:
+            return startupKernel != LevenshteinKernel::Scalar;
+        default:
+            return true;
+    }
+}
+
+const char* levenshteinKernelName(LevenshteinKernel kernel) {
+    switch (kernel) {
+        case LevenshteinKernel::AVX2: return "avx2";
+        case LevenshteinKernel::SSE41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+int levenshteinWithKernel(LevenshteinKernel kernel, const string& s1, const string& s2,
+                          LevenshteinScratch& scratch) {
+    int m = s1.length();
+    int n = s2.length();
+
+    if (m == 0) return n;
+    if (n == 0) return m;
+
+    int longest = max(m, n);
+    if (!levenshteinKernelSupported(kernel) || longest >= 65535) {
+        kernel = LevenshteinKernel::Scalar;
+    }
+
+#ifdef SIMD_LEVENSHTEIN_X86
+    // Distances never exceed the longer length, so uint8_t lanes cannot saturate below 255
+    bool narrow = longest < 255;
+    switch (kernel) {
+        case LevenshteinKernel::AVX2:
+            return narrow ? runDiagonals<uint8_t>(s1, s2, scratch.diag8, scratch, interiorAVX2U8)
+                          : runDiagonals<uint16_t>(s1, s2, scratch.diag16, scratch, interiorAVX2U16);
+        case LevenshteinKernel::SSE41:
+            return narrow ? runDiagonals<uint8_t>(s1, s2, scratch.diag8, scratch, interiorSSE41U8)
+                          : runDiagonals<uint16_t>(s1, s2, scratch.diag16, scratch, interiorSSE41U16);
+        default:
+            break;
+    }
+#endif
+
+    return twoRowLevenshtein(s1, s2, scratch);
+}
+
+int simdLevenshtein(const string& s1, const string& s2, LevenshteinScratch& scratch) {
+    bool shortInput = max(s1.length(), s2.length()) < static_cast<size_t>(kSimdMinLength);
+    return levenshteinWithKernel(shortInput ? LevenshteinKernel::Scalar : startupKernel, s1, s2, scratch);
+}
+
+int simdLevenshtein(const string& s1, const string& s2) {
+    static thread_local LevenshteinScratch scratch;
+    return simdLevenshtein(s1, s2, scratch);
+}
+
+void batchLevenshtein(const string& target, const vector<const string*>& candidates,
+                      vector<int>& distances, CandidateBatchScratch& scratch, int bound) {
+    distances.resize(candidates.size());
+    auto clampToBound = [bound](int d) { return (bound >= 0 && d > bound) ? bound + 1 : d; };
+
+    size_t lanes = 1;
+#ifdef SIMD_LEVENSHTEIN_X86
+    if (startupKernel == LevenshteinKernel::AVX2) lanes = 32;
+    else if (startupKernel == LevenshteinKernel::SSE41) lanes = 16;
+#endif
+
+    if (lanes == 1 || target.length() >= 255) {
+        for (size_t c = 0; c < candidates.size(); c++) {
+            distances[c] = clampToBound(twoRowLevenshtein(target, *candidates[c], scratch.single));
+        }
+        return;
+    }
+
+#ifdef SIMD_LEVENSHTEIN_X86
+    size_t next = 0;
+    while (next < candidates.size()) {
+        // Fill up to one vector of lanes; overlong candidates take the scalar path
+        size_t laneOf[32];
+        size_t filled = 0;
+        int maxLen = 0;
+        while (filled < lanes && next < candidates.size()) {
+            const string& candidate = *candidates[next];
+            if (candidate.length() >= 255) {
+                distances[next] = clampToBound(twoRowLevenshtein(target, candidate, scratch.single));
+            } else {
+                laneOf[filled++] = next;
+                maxLen = max(maxLen, static_cast<int>(candidate.length()));
+            }
+            next++;
+        }
+        if (filled == 0) break;
+
+        // Column-major packing: character j of every candidate side by side
+        size_t columnBytes = static_cast<size_t>(maxLen) * lanes;
+        if (scratch.columns.size() < columnBytes) scratch.columns.resize(columnBytes);
+        if (scratch.rows.size() < columnBytes + lanes) scratch.rows.resize(columnBytes + lanes);
+        fill(scratch.columns.begin(), scratch.columns.begin() + columnBytes, 0);
+        for (size_t lane = 0; lane < filled; lane++) {
+            const string& candidate = *candidates[laneOf[lane]];
+            for (size_t j = 0; j < candidate.length(); j++) {
+                scratch.columns[j * lanes + lane] = static_cast<uint8_t>(candidate[j]);
+            }
+        }
+
+        bool complete = lanes == 32
+            ? batchRowsAVX2(scratch.columns.data(), maxLen, target, scratch.rows.data(), bound)
+            : batchRowsSSE41(scratch.columns.data(), maxLen, target, scratch.rows.data(), bound);
+
+        // Each lane's answer sits in the column of its own length
+        for (size_t lane = 0; lane < filled; lane++) {
+            size_t index = laneOf[lane];
+            size_t length = candidates[index]->length();
+            distances[index] = complete ? clampToBound(scratch.rows[length * lanes + lane]) : bound + 1;
+        }
+    }
+#endif
+}
+
+vector<pair<int, string>> rankCandidatesByDistance(const string& target, const vector<string>& candidates,
+                                                  int maxDist) {
+    static thread_local CandidateBatchScratch scratch;
+
+    vector<const string*> pointers;
+    pointers.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+        pointers.push_back(&candidate);
+    }
+
+    vector<int> distances;
+    batchLevenshtein(target, pointers, distances, scratch, maxDist);
+
+    vector<pair<int, string>> ranked;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (maxDist < 0 || distances[i] <= maxDist) {
+            ranked.push_back({distances[i], candidates[i]});
+        }
+    }
+    stable_sort(ranked.begin(), ranked.end(),
+                [](const pair<int, string>& a, const pair<int, string>& b) { return a.first < b.first; });
+    return ranked;
+}
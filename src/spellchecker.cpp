@@ -1,15 +1,69 @@
 #include "../include/spellchecker.h"
+#include "../include/cascade_engine.h"
+#include <omp.h>
+
+// Phonetic candidates allowed to displace a method's own suggestions
+static const size_t PHONETIC_SLOTS = 2;
+
+// Sound-alike spellings drift further than typos: "nashun" is three edits from "nation"
+static const int PHONETIC_EXTRA_DISTANCE = 2;
+
+// kd-tree neighbours fetched per suggestion when re-ranking: start at the
+// minimum and double while the fetched distances are flat, up to the maximum
+static const size_t KDTREE_OVERFETCH_MIN = 4;
+static const size_t KDTREE_OVERFETCH_MAX = 32;
+
+// Fetched distances are flat when the furthest is within this fraction of
+// the k-th: the 5-D position then cannot tell the candidates apart
+static const double KDTREE_FLAT_SPREAD = 0.5;
 
 // Constructor and Destructor
 
+// Unit-cost trie searches with a common signature for dispatch
+template<int K>
+static vector<string> bandedTrieSearch(Trie& trie, const string& word, int) {
+    return trie.getSimilarWordsBanded<K>(word);
+}
+
+static vector<string> genericTrieSearch(Trie& trie, const string& word, int maxDist) {
+    return trie.getSimilarWords<UnitCost>(word, maxDist);
+}
+
+static vector<string> keyboardTrieSearch(Trie& trie, const string& word, int maxDist) {
+    return trie.getSimilarWords<KeyboardCost>(word, maxDist);
+}
+
 SpellChecker::SpellChecker(int maxDist, int maxSugg) 
-    : maxEditDistance(maxDist), maxSuggestions(maxSugg) {
+    : earlyStopLevel(0), symspellStale(true), qgramStale(true), phoneticStale(true), bucketKdtreeStale(true),
+      bigramTreeStale(true),
+      maxEditDistance(maxDist), maxSuggestions(maxSugg), astarIterativeDeepening(true),
+      costModel(EditCostModel::Unit), phoneticMerge(false), bucketKdtreeSearch(false),
+      kdtreeChecks(0), kdtreeRerank(false), kdtreeBigrams(false) {
+    switch (maxEditDistance) {
+        case 1: unitTrieSearch = bandedTrieSearch<1>; break;
+        case 2: unitTrieSearch = bandedTrieSearch<2>; break;
+        case 3: unitTrieSearch = bandedTrieSearch<3>; break;
+        default: unitTrieSearch = genericTrieSearch; break;
+    }
+    
     trie = new Trie();
     kdtree = new KDTree();
     astarChecker = new AStarSpellChecker(trie);
+    astarChecker->setSignatureTable(&signatures);
+    astarChecker->setFrequencyStore(&frequencies);
+    bktree = new BKTree();
+    
+    registerEngine(make_unique<AStarEngine>(*this, "astar", "A* search with Levenshtein distance (recommended)"));
+    registerEngine(make_unique<TrieEngine>(*this, "trie", "Direct Trie traversal with Levenshtein"));
+    registerEngine(make_unique<KDTreeEngine>(*this, "kdtree", "KD-Tree semantic similarity"));
+    registerEngine(make_unique<SymSpellEngine>(*this, "symspell", "Symmetric delete index (fastest lookups)"));
+    registerEngine(make_unique<BKTreeEngine>(*this, "bktree", "BK-tree metric search on edit distance"));
+    registerEngine(make_unique<QGramEngine>(*this, "qgram", "Bigram inverted index (best for long words)"));
+    registerEngine(make_unique<CascadeEngine>(*this));
 }
 
 SpellChecker::~SpellChecker() {
+    delete bktree;
     delete astarChecker;
     delete kdtree;
     delete trie;
@@ -84,23 +138,45 @@ bool SpellChecker::loadDictionary(const string& filename) {
     
     while (file >> word) {
         string cleaned = cleanWord(word);
-        if (!cleaned.empty() && cleaned.length() > 1) {  // Skip single letters
-            trie->insert(cleaned);
-            kdtree->insert(cleaned);
+        if (!cleaned.empty() && cleaned.length() > 1 && !trie->contains(cleaned)) {  // Skip single letters
+            trie->insert(cleaned, signatures.add(cleaned));
+            bktree->insert(cleaned);
+            if (shards) shards->insert(cleaned, signatures.size() - 1);
+            symspellStale = true;
+            qgramStale = true;
+            phoneticStale = true;
+            bucketKdtreeStale = true;
+            bigramTreeStale = true;
             count++;
         }
     }
     
     file.close();
+    
+    // Inserting in file order (alphabetical) degenerates the kd-tree into
+    // long chains; a median-split rebuild over all words keeps it balanced
+    if (count > 0) {
+        kdtree->build(signatures.getWords());
+    }
+    
+    // Phonetic codes are cheap enough to compute up front
+    getPhoneticIndex();
     cout << "Loaded " << count << " words into dictionary." << endl;
     return true;
 }
 
 void SpellChecker::addWord(const string& word) {
     string cleaned = cleanWord(word);
-    if (!cleaned.empty()) {
-        trie->insert(cleaned);
+    if (!cleaned.empty() && !trie->contains(cleaned)) {
+        trie->insert(cleaned, signatures.add(cleaned));
         kdtree->insert(cleaned);
+        bktree->insert(cleaned);
+        if (shards) shards->insert(cleaned, signatures.size() - 1);
+        symspellStale = true;
+        qgramStale = true;
+        phoneticStale = true;
+        bucketKdtreeStale = true;
+        bigramTreeStale = true;
     }
 }
 
@@ -110,54 +186,111 @@ bool SpellChecker::isValidWord(const string& word) {
 }
 
 int SpellChecker::getDictionarySize() const {
-    // Note: This would require adding a size() method to Trie
-    // For now, return -1 to indicate not implemented
-    return -1;
+    return signatures.size();
 }
 
-// Spell checking methods
+// Word frequencies
 
-SpellCheckResult SpellChecker::checkText(const string& text, const string& method) {
-    SpellCheckResult result;
-    result.totalWords = 0;
-    result.correctWords = 0;
-    result.incorrectWords = 0;
-    
-    auto startTime = chrono::high_resolution_clock::now();
-    
-    vector<pair<string, int>> tokens = tokenizeWithLineNumbers(text);
-    result.totalWords = tokens.size();
-    
-    int position = 0;
-    for (const auto& [word, lineNum] : tokens) {
-        if (!isValidWord(word)) {
-            SpellingError error;
-            error.originalWord = word;
-            error.position = position;
-            error.lineNumber = lineNum;
-            error.method = method;
-            
-            // Get suggestions based on method
-            if (method == "trie") {
-                error.suggestions = getSuggestionsTrie(word);
-            } else if (method == "kdtree") {
-                error.suggestions = getSuggestionsKDTree(word);
-            } else {  // default to astar
-                error.suggestions = getSuggestionsAStar(word);
-            }
-            
-            result.errors.push_back(error);
-            result.incorrectWords++;
-        } else {
-            result.correctWords++;
+bool SpellChecker::loadFrequencies(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Error: Could not open frequency file: " << filename << endl;
+        return false;
+    }
+    
+    string line;
+    int count = 0;
+    while (getline(file, line)) {
+        istringstream fields(line);
+        string word;
+        uint64_t frequency;
+        if (!(fields >> word >> frequency)) continue;
+        
+        int id = trie->getWordId(cleanWord(word));
+        if (id >= 0) {
+            frequencies.setCount(id, frequency);
+            count++;
         }
-        position++;
     }
     
-    auto endTime = chrono::high_resolution_clock::now();
-    result.processingTimeMs = chrono::duration<double, milli>(endTime - startTime).count();
+    cout << "Loaded frequencies for " << count << " dictionary words." << endl;
+    return true;
+}
+
+void SpellChecker::setWordFrequency(const string& word, uint64_t count) {
+    frequencies.setCount(trie->getWordId(cleanWord(word)), count);
+}
+
+int SpellChecker::getWordFrequencyLevel(const string& word) {
+    return frequencies.level(trie->getWordId(cleanWord(word)));
+}
+
+void SpellChecker::setLengthPartitioning(bool enabled, bool parallelShards) {
+    if (!enabled) {
+        shards.reset();
+        return;
+    }
+    if (!shards) {
+        shards = make_unique<LengthShardedIndex>();
+        for (size_t id = 0; id < signatures.size(); id++) {
+            shards->insert(signatures.word(id), id);
+        }
+    }
+    shards->setParallel(parallelShards);
+}
+
+void SpellChecker::setEarlyStopFrequency(uint8_t level) {
+    earlyStopLevel = level;
+    astarChecker->setFrequencyStore(&frequencies, level);
+}
+
+// Suggestion engines
+
+vector<vector<string>> SuggestionEngine::suggestBatch(const vector<string>& words, vector<SearchContext>& contexts) {
+    vector<vector<string>> suggestions(words.size());
+    int threads = static_cast<int>(contexts.size());
     
-    return result;
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(threads) schedule(dynamic) if(threads > 1)
+    #endif
+    for (size_t i = 0; i < words.size(); i++) {
+        #ifdef _OPENMP
+        SearchContext& context = contexts[omp_get_thread_num()];
+        #else
+        SearchContext& context = contexts[0];
+        #endif
+        suggestions[i] = suggest(words[i], context);
+    }
+    return suggestions;
+}
+
+void SpellChecker::registerEngine(unique_ptr<SuggestionEngine> engine) {
+    for (auto& existing : engines) {
+        if (existing->name() == engine->name()) {
+            existing = move(engine);
+            return;
+        }
+    }
+    engines.push_back(move(engine));
+}
+
+SuggestionEngine* SpellChecker::findEngine(const string& name) const {
+    for (const auto& engine : engines) {
+        if (engine->name() == name) return engine.get();
+    }
+    return nullptr;
+}
+
+SuggestionEngine& SpellChecker::getEngine(const string& name) const {
+    SuggestionEngine* engine = findEngine(name);
+    return engine ? *engine : *engines.front();
+}
+
+// Spell checking methods
+
+SpellCheckResult SpellChecker::checkText(const string& text, const string& method) {
+    // The name is resolved once; each misspelled word costs one virtual call
+    return checkText(text, getEngine(method));
 }
 
 SpellCheckResult SpellChecker::checkFile(const string& filename, const string& method) {
@@ -176,8 +309,29 @@ SpellCheckResult SpellChecker::checkFile(const string& filename, const string& m
 
 // Get suggestions for a single word
 
+void SpellChecker::rankByCostModel(const string& word, vector<string>& suggestions) {
+    vector<pair<int, int>> ranked;  // (distance, word id)
+    if (costModel != EditCostModel::Keyboard) {
+        // Distances verified a SIMD batch of candidates at a time
+        for (const auto& [dist, s] : rankCandidatesByDistance(word, suggestions)) {
+            ranked.push_back({dist, trie->getWordId(s)});
+        }
+    } else {
+        for (const auto& s : suggestions) {
+            ranked.push_back({weightedEditDistance<KeyboardCost>(s, word), trie->getWordId(s)});
+        }
+    }
+    suggestions = topSuggestions(ranked);
+}
+
 vector<string> SpellChecker::getSuggestionsTrie(const string& word) {
-    vector<string> suggestions = trie->getSimilarWords(word, maxEditDistance);
+    // Insertions and deletions cost a full edit in both models, so the
+    // partitions' length bound holds for either
+    auto search = costModel == EditCostModel::Keyboard ? keyboardTrieSearch : unitTrieSearch;
+    vector<string> suggestions = shards
+        ? shards->getSimilarWords(word, maxEditDistance, search)
+        : search(*trie, word, maxEditDistance);
+    rankByCostModel(word, suggestions);
     
     // Limit to maxSuggestions
     if (suggestions.size() > static_cast<size_t>(maxSuggestions)) {
@@ -187,23 +341,303 @@ vector<string> SpellChecker::getSuggestionsTrie(const string& word) {
     return suggestions;
 }
 
+vector<pair<double, string>> SpellChecker::kdtreeNeighbours(const string& word, size_t k) {
+    if (kdtreeBigrams) {
+        return getBigramTree().findKNearest(word, k, kdtreeChecks);
+    }
+    
+    vector<Position> positions;
+    if (shards) {
+        positions = shards->findKNearest(word, k, maxEditDistance);
+    } else if (bucketKdtreeSearch) {
+        positions = getBucketKDTree().findKNearest(word, k);
+    } else if (kdtreeChecks > 0) {
+        positions = kdtree->findKNearestApprox(word, k, kdtreeChecks);
+    } else {
+        positions = kdtree->findKNearest(word, k);
+    }
+    
+    Position target = Position::fromWord(word);
+    vector<pair<double, string>> neighbours;
+    for (auto& pos : positions) {
+        neighbours.push_back({pos.distance(target), move(pos.word)});
+    }
+    return neighbours;
+}
+
 vector<string> SpellChecker::getSuggestionsKDTree(const string& word) {
-    vector<Position> positions = kdtree->findKNearest(word, maxSuggestions);
+    if (kdtreeRerank) {
+        return rerankKDTreeNeighbours(word);
+    }
     
     vector<string> suggestions;
-    for (const auto& pos : positions) {
-        suggestions.push_back(pos.word);
+    for (auto& [dist, neighbour] : kdtreeNeighbours(word, maxSuggestions)) {
+        suggestions.push_back(move(neighbour));
+    }
+    
+    return suggestions;
+}
+
+vector<string> SpellChecker::rerankKDTreeNeighbours(const string& word) {
+    static thread_local vector<int> ids;
+    
+    size_t k = maxSuggestions;
+    vector<pair<double, string>> neighbours;
+    for (size_t factor = KDTREE_OVERFETCH_MIN; ; factor *= 2) {
+        neighbours = kdtreeNeighbours(word, factor * k);
+        if (factor >= KDTREE_OVERFETCH_MAX || neighbours.size() <= k) break;
+        double kth = neighbours[k - 1].first;
+        double furthest = neighbours.back().first;
+        if (furthest - kth > KDTREE_FLAT_SPREAD * furthest) break;
+    }
+    
+    // Signature bound first, then the banded kernel on the survivors
+    WordSignature signature = WordSignature::of(word);
+    ids.clear();
+    for (const auto& [dist, neighbour] : neighbours) {
+        int id = trie->getWordId(neighbour);
+        if (id >= 0 && signatures.mayMatch(id, signature, maxEditDistance)) {
+            ids.push_back(id);
+        }
     }
+    vector<string> suggestions = verifyCandidateIds(word, ids);
     
+    // Too few within maxEditDistance: fill up with the nearest neighbours
+    for (const auto& [dist, neighbour] : neighbours) {
+        if (suggestions.size() >= k) break;
+        if (find(suggestions.begin(), suggestions.end(), neighbour) == suggestions.end()) {
+            suggestions.push_back(neighbour);
+        }
+    }
     return suggestions;
 }
 
+vector<vector<string>> SpellChecker::getSuggestionsKDTreeBatch(const vector<string>& words, int threads) {
+    vector<vector<string>> suggestions(words.size());
+    if (!bucketKdtreeSearch || shards || kdtreeRerank || kdtreeBigrams || kdtreeChecks > 0) {
+        #ifdef _OPENMP
+        #pragma omp parallel for num_threads(max(threads, 1)) schedule(dynamic) if(threads > 1)
+        #endif
+        for (size_t i = 0; i < words.size(); i++) {
+            suggestions[i] = getSuggestionsKDTree(words[i]);
+        }
+        return suggestions;
+    }
+    
+    vector<vector<Position>> positions = getBucketKDTree().findKNearestBatch(words, maxSuggestions, threads);
+    for (size_t i = 0; i < words.size(); i++) {
+        for (const auto& pos : positions[i]) {
+            suggestions[i].push_back(pos.word);
+        }
+    }
+    return suggestions;
+}
+
+vector<string> SpellChecker::verifyCandidateIds(const string& word, const vector<int>& ids, int maxDist) {
+    static thread_local vector<const string*> candidates;
+    static thread_local vector<int> distances;
+    static thread_local CandidateBatchScratch scratch;
+    
+    if (maxDist < 0) maxDist = maxEditDistance;
+    
+    candidates.clear();
+    for (int id : ids) {
+        candidates.push_back(&signatures.word(id));
+    }
+    batchLevenshtein(word, candidates, distances, scratch, maxDist);
+    
+    vector<pair<int, int>> ranked;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (distances[i] <= maxDist) {
+            ranked.push_back({distances[i], ids[i]});
+        }
+    }
+    return topSuggestions(ranked);
+}
+
+vector<string> SpellChecker::topSuggestions(vector<pair<int, int>>& ranked) {
+    auto better = [this](const pair<int, int>& a, const pair<int, int>& b) {
+        if (a.first != b.first) return a.first < b.first;
+        uint8_t levelA = frequencies.level(a.second), levelB = frequencies.level(b.second);
+        if (levelA != levelB) return levelA > levelB;
+        return signatures.word(a.second) < signatures.word(b.second);
+    };
+    
+    // Only the first maxSuggestions need to be in order
+    size_t k = min(ranked.size(), static_cast<size_t>(maxSuggestions));
+    partial_sort(ranked.begin(), ranked.begin() + k, ranked.end(), better);
+    
+    vector<string> suggestions;
+    for (size_t i = 0; i < k; i++) {
+        suggestions.push_back(signatures.word(ranked[i].second));
+    }
+    return suggestions;
+}
+
+vector<string> SpellChecker::getSuggestionsScan(const string& word) {
+    static thread_local vector<int> ids;
+    
+    // Only words whose length and letter set allow a match reach the DP
+    signatures.scan(word, maxEditDistance, ids);
+    return verifyCandidateIds(word, ids);
+}
+
+const SymSpellIndex& SpellChecker::getSymSpellIndex() {
+    // Double-checked so concurrent queries build the index only once
+    if (symspellStale.load(memory_order_acquire)) {
+        lock_guard<mutex> lock(indexMutex);
+        if (symspellStale.load(memory_order_relaxed)) {
+            symspell.build(signatures.getWords(), maxEditDistance);
+            symspellStale.store(false, memory_order_release);
+        }
+    }
+    return symspell;
+}
+
+vector<string> SpellChecker::getSuggestionsSymSpell(const string& word) {
+    return getSuggestionsSymSpell(word, maxEditDistance);
+}
+
+vector<string> SpellChecker::getSuggestionsSymSpell(const string& word, int maxDist) {
+    static thread_local vector<int> ids;
+    static thread_local SymSpellIndex::LookupContext context;
+    
+    maxDist = min(maxDist, maxEditDistance);
+    getSymSpellIndex().lookup(word, maxDist, ids, context);
+    
+    // Shared deletions admit words up to 2 * maxDist away; the
+    // signature bound drops most of those before the DP
+    WordSignature signature = WordSignature::of(word);
+    ids.erase(remove_if(ids.begin(), ids.end(),
+                        [&](int id) { return !signatures.mayMatch(id, signature, maxDist); }),
+              ids.end());
+    return verifyCandidateIds(word, ids, maxDist);
+}
+
+const QGramIndex& SpellChecker::getQGramIndex() {
+    if (qgramStale.load(memory_order_acquire)) {
+        lock_guard<mutex> lock(indexMutex);
+        if (qgramStale.load(memory_order_relaxed)) {
+            qgrams.build(signatures.getWords());
+            qgramStale.store(false, memory_order_release);
+        }
+    }
+    return qgrams;
+}
+
+vector<string> SpellChecker::getSuggestionsQGram(const string& word) {
+    static thread_local vector<int> ids;
+    static thread_local QGramIndex::LookupContext context;
+    
+    // Count filtering leaves few candidates for long words, where the
+    // trie and A* searches branch the most
+    getQGramIndex().lookup(word, maxEditDistance, ids, context);
+    return verifyCandidateIds(word, ids);
+}
+
+const PhoneticIndex& SpellChecker::getPhoneticIndex() {
+    if (phoneticStale.load(memory_order_acquire)) {
+        lock_guard<mutex> lock(indexMutex);
+        if (phoneticStale.load(memory_order_relaxed)) {
+            phonetics.build(signatures.getWords());
+            phoneticStale.store(false, memory_order_release);
+        }
+    }
+    return phonetics;
+}
+
+const BucketKDTree& SpellChecker::getBucketKDTree() {
+    if (bucketKdtreeStale.load(memory_order_acquire)) {
+        lock_guard<mutex> lock(indexMutex);
+        if (bucketKdtreeStale.load(memory_order_relaxed)) {
+            bucketKdtree.build(signatures.getWords());
+            bucketKdtreeStale.store(false, memory_order_release);
+        }
+    }
+    return bucketKdtree;
+}
+
+void SpellChecker::setKDTreeBigrams(bool enabled, int dimensions) {
+    kdtreeBigrams = enabled;
+    if (enabled && dimensions != bigramTree.getDimensions()) {
+        lock_guard<mutex> lock(indexMutex);
+        bigramTree = VPTree(dimensions);
+        bigramTreeStale = true;
+    }
+}
+
+const VPTree& SpellChecker::getBigramTree() {
+    if (bigramTreeStale.load(memory_order_acquire)) {
+        lock_guard<mutex> lock(indexMutex);
+        if (bigramTreeStale.load(memory_order_relaxed)) {
+            bigramTree.build(signatures.getWords());
+            bigramTreeStale.store(false, memory_order_release);
+        }
+    }
+    return bigramTree;
+}
+
+vector<string> SpellChecker::getPhoneticCandidates(const string& word) {
+    static thread_local vector<int> ids;
+    
+    // Short codes are shared by many words; the distance bound keeps the
+    // ones that are also spelled alike
+    getPhoneticIndex().lookup(word, ids);
+    return verifyCandidateIds(word, ids, maxEditDistance + PHONETIC_EXTRA_DISTANCE);
+}
+
+void SpellChecker::mergePhoneticCandidates(const string& word, vector<string>& suggestions) {
+    vector<string> extra;
+    for (const string& candidate : getPhoneticCandidates(word)) {
+        if (find(suggestions.begin(), suggestions.end(), candidate) == suggestions.end()) {
+            extra.push_back(candidate);
+        }
+    }
+    
+    // Fill free slots, and take over at most PHONETIC_SLOTS of the method's
+    // lowest-ranked suggestions
+    size_t limit = maxSuggestions;
+    size_t freeSlots = limit > suggestions.size() ? limit - suggestions.size() : 0;
+    size_t take = min(extra.size(), max(freeSlots, min(PHONETIC_SLOTS, limit)));
+    suggestions.resize(min(suggestions.size(), limit - take));
+    suggestions.insert(suggestions.end(), extra.begin(), extra.begin() + take);
+}
+
+vector<string> SpellChecker::getSuggestionsBKTree(const string& word) {
+    static thread_local vector<pair<int, string>> found;
+    bktree->search(word, maxEditDistance, found);
+    
+    vector<pair<int, int>> ranked;
+    for (const auto& [dist, s] : found) {
+        ranked.push_back({dist, trie->getWordId(s)});
+    }
+    return topSuggestions(ranked);
+}
+
 vector<string> SpellChecker::getSuggestionsAStar(const string& word) {
-    vector<pair<int, string>> results = astarChecker->findSimilarWords(word, maxEditDistance);
+    // Callers without their own context reuse one per thread
+    static thread_local SearchContext context;
+    return getSuggestionsAStar(word, context);
+}
+
+vector<string> SpellChecker::getSuggestionsAStar(const string& word, SearchContext& context) {
+    // The cost model is resolved here, once per query; the search loops are
+    // compiled separately for each policy
+    const vector<pair<int, const TrieNode*>>* resultsPtr;
+    if (costModel == EditCostModel::Keyboard) {
+        resultsPtr = astarIterativeDeepening
+            ? &astarChecker->findSimilarWordsIterative<KeyboardCost>(word, maxEditDistance, maxSuggestions, context)
+            : &astarChecker->findSimilarWords<KeyboardCost>(word, maxEditDistance, context);
+    } else {
+        resultsPtr = astarIterativeDeepening
+            ? &astarChecker->findSimilarWordsIterative<UnitCost>(word, maxEditDistance, maxSuggestions, context)
+            : &astarChecker->findSimilarWords<UnitCost>(word, maxEditDistance, context);
+    }
+    const vector<pair<int, const TrieNode*>>& results = *resultsPtr;
     
     vector<string> suggestions;
-    for (const auto& [dist, w] : results) {
-        suggestions.push_back(w);
+    for (const auto& [dist, node] : results) {
+        suggestions.push_back(node->word);
         if (suggestions.size() >= static_cast<size_t>(maxSuggestions)) {
             break;
         }
@@ -251,5 +685,17 @@ void SpellChecker::compareMethodsForWord(const string& word) {
         cout << "  Suggestions: ";
         for (const auto& s : astarSugg) cout << s << " ";
         cout << endl;
+        
+        // SymSpell method (the first query builds the index)
+        getSymSpellIndex();
+        auto startSym = chrono::high_resolution_clock::now();
+        vector<string> symSugg = getSuggestionsSymSpell(word);
+        auto endSym = chrono::high_resolution_clock::now();
+        double symTime = chrono::duration<double, milli>(endSym - startSym).count();
+        
+        cout << "\nSymSpell (Deletion Index) - Time: " << fixed << setprecision(3) << symTime << " ms" << endl;
+        cout << "  Suggestions: ";
+        for (const auto& s : symSugg) cout << s << " ";
+        cout << endl;
     }
 }
@@ -0,0 +1,141 @@
+#include "../include/symspell.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// All distinct strings reachable from word by deleting 0..maxDist characters
+void collectDeletes(const string& word, int maxDist, vector<string>& deletes) {
+    deletes.clear();
+    deletes.push_back(word);
+
+    size_t levelBegin = 0;
+    for (int level = 1; level <= maxDist; level++) {
+        size_t levelEnd = deletes.size();
+        for (size_t i = levelBegin; i < levelEnd; i++) {
+            // Copy: push_back below may reallocate deletes
+            string source = deletes[i];
+            for (size_t pos = 0; pos < source.length(); pos++) {
+                // Deleting any character of a run gives the same string
+                if (pos > 0 && source[pos] == source[pos - 1]) continue;
+                string shorter = source;
+                shorter.erase(pos, 1);
+                deletes.push_back(move(shorter));
+            }
+        }
+        levelBegin = levelEnd;
+    }
+
+    sort(deletes.begin(), deletes.end());
+    deletes.erase(unique(deletes.begin(), deletes.end()), deletes.end());
+}
+
+} // namespace
+
+SymSpellIndex::SymSpellIndex() : maxDist(0), wordCount(0) {}
+
+uint64_t SymSpellIndex::hashOf(const string& key) {
+    // FNV-1a, then a final avalanche so the low bits are usable as a slot index
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (char c : key) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+void SymSpellIndex::build(const vector<string>& words, int maxDistance) {
+    maxDist = maxDistance;
+    wordCount = words.size();
+
+    // (key hash, word id) for every deletion of every word
+    vector<pair<uint64_t, int>> pairs;
+    vector<string> deletes;
+    for (size_t id = 0; id < words.size(); id++) {
+        collectDeletes(words[id], maxDist, deletes);
+        for (const auto& key : deletes) {
+            pairs.push_back({hashOf(key), static_cast<int>(id)});
+        }
+    }
+    sort(pairs.begin(), pairs.end());
+    pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+    size_t keys = 0;
+    for (size_t i = 0; i < pairs.size(); i++) {
+        if (i == 0 || pairs[i].first != pairs[i - 1].first) keys++;
+    }
+
+    // Load factor at most three quarters keeps linear probes short
+    size_t capacity = 16;
+    while (capacity * 3 < keys * 4) capacity <<= 1;
+    table.assign(capacity, Entry{0, 0, 0});
+    postings.resize(pairs.size());
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < pairs.size();) {
+        size_t j = i;
+        while (j < pairs.size() && pairs[j].first == pairs[i].first) {
+            postings[j] = pairs[j].second;
+            j++;
+        }
+
+        size_t slot = pairs[i].first & mask;
+        while (table[slot].count != 0) slot = (slot + 1) & mask;
+        table[slot] = Entry{pairs[i].first, static_cast<uint32_t>(i), static_cast<uint32_t>(j - i)};
+        i = j;
+    }
+}
+
+const SymSpellIndex::Entry* SymSpellIndex::find(uint64_t hash) const {
+    if (table.empty()) return nullptr;
+
+    size_t mask = table.size() - 1;
+    size_t slot = hash & mask;
+    while (table[slot].count != 0) {
+        if (table[slot].hash == hash) return &table[slot];
+        slot = (slot + 1) & mask;
+    }
+    return nullptr;
+}
+
+void SymSpellIndex::lookup(const string& query, int maxDistance, vector<int>& ids, LookupContext& context) const {
+    ids.clear();
+    if (context.seen.size() < wordCount) {
+        context.seen.assign(wordCount, 0);
+        context.epoch = 0;
+    }
+    if (++context.epoch == 0) {
+        fill(context.seen.begin(), context.seen.end(), 0);
+        context.epoch = 1;
+    }
+
+    // Deletions beyond the indexed depth would have nothing to match
+    collectDeletes(query, min(maxDistance, maxDist), context.deletes);
+    for (const auto& key : context.deletes) {
+        const Entry* entry = find(hashOf(key));
+        if (!entry) continue;
+
+        for (uint32_t p = entry->begin; p < entry->begin + entry->count; p++) {
+            int id = postings[p];
+            if (context.seen[id] != context.epoch) {
+                context.seen[id] = context.epoch;
+                ids.push_back(id);
+            }
+        }
+    }
+}
+
+size_t SymSpellIndex::keyCount() const {
+    size_t keys = 0;
+    for (const auto& entry : table) {
+        if (entry.count != 0) keys++;
+    }
+    return keys;
+}
+
+size_t SymSpellIndex::memoryBytes() const {
+    return table.capacity() * sizeof(Entry) + postings.capacity() * sizeof(int);
+}
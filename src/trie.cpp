@@ -34,38 +34,49 @@ bool Trie::remove(TrieNode* curr, const string& word, int depth) { // remove for
     return false;
 }
 
-void Trie::searchRecursive(TrieNode* node, char letter, const string& target, 
-                     const vector<int>& prevRow, vector<string>& results, int maxDist) {
+template<typename Cost>
+void Trie::searchRecursive(TrieNode* node, char letter, char prevLetter, const string& target, 
+                     const vector<int>& prevRow, const vector<int>* prevPrevRow,
+                     vector<string>& results, int maxCost, size_t* rowsVisited) {
+    if (rowsVisited) (*rowsVisited)++;
     
     int columns = target.size() + 1;
     vector<int> currentRow(columns);
-    currentRow[0] = prevRow[0] + 1;
+    currentRow[0] = prevRow[0] + Cost::deleteCost(letter);
 
     int minRowCost = currentRow[0];
 
     for (int i = 1; i < columns; i++) {
-        int insertCost = currentRow[i - 1] + 1;
-        int deleteCost = prevRow[i] + 1;
-        int replaceCost = prevRow[i - 1];
-        
-        if (target[i - 1] != letter) {
-            replaceCost += 1;
-        }
+        int insertCost = currentRow[i - 1] + Cost::insertCost(target[i - 1]);
+        int deleteCost = prevRow[i] + Cost::deleteCost(letter);
+        int replaceCost = prevRow[i - 1] + Cost::substituteCost(target[i - 1], letter);
 
         currentRow[i] = min({ insertCost, deleteCost, replaceCost });
+
+        // Swapped neighbours: this letter and the previous one appear
+        // in the opposite order in the target
+        if constexpr (Cost::hasTransposition) {
+            if (prevPrevRow && i > 1 && letter == target[i - 2] && prevLetter == target[i - 1] &&
+                letter != prevLetter) {
+                currentRow[i] = min(currentRow[i], (*prevPrevRow)[i - 2] + Cost::transposeCost());
+            }
+            // A grandchild can still transpose from this node's parent row
+            minRowCost = min(minRowCost, prevRow[i - 1] + Cost::transposeCost());
+        }
+
         minRowCost = min(minRowCost, currentRow[i]);
     }
 
-    if (minRowCost > maxDist) {
+    if (minRowCost > maxCost) {
         return;
     }
 
-    if (node->isEndOfWord && currentRow.back() <= maxDist) {
+    if (node->isEndOfWord && currentRow.back() <= maxCost) {
         results.push_back(node->word);
     }
 
     for (auto const& [key, childNode] : node->children) {
-        searchRecursive(childNode, key, target, currentRow, results, maxDist);
+        searchRecursive<Cost>(childNode, key, letter, target, currentRow, &prevRow, results, maxCost, rowsVisited);
     }
 }
 
@@ -79,7 +90,7 @@ Trie::~Trie() {
     clear(root);
 }
 
-void Trie::insert(const string& word) {
+void Trie::insert(const string& word, int wordId) {
     TrieNode* curr = root;
     for (char c : word) {
         if (curr->children.find(c) == curr->children.end()) {
@@ -89,6 +100,9 @@ void Trie::insert(const string& word) {
     }
     curr->isEndOfWord = true;
     curr->word = word;
+    if (wordId >= 0) {
+        curr->wordId = wordId;
+    }
 }
 
 bool Trie::contains(const string& word) {
@@ -102,19 +116,102 @@ bool Trie::contains(const string& word) {
     return curr != nullptr && curr->isEndOfWord;
 }
 
+int Trie::getWordId(const string& word) {
+    TrieNode* curr = root;
+    for (char c : word) {
+        auto it = curr->children.find(c);
+        if (it == curr->children.end()) {
+            return -1;
+        }
+        curr = it->second;
+    }
+    return curr->isEndOfWord ? curr->wordId : -1;
+}
+
 void Trie::remove(const string& key) {
     remove(root, key, 0);
 }
 
-vector<string> Trie::getSimilarWords(const string& word, int maxDist) {
+template<typename Cost>
+vector<string> Trie::getSimilarWords(const string& word, int maxDist, size_t* rowsVisited) {
     vector<string> results;
     
     vector<int> currentRow(word.size() + 1);
-    iota(currentRow.begin(), currentRow.end(), 0);
+    currentRow[0] = 0;
+    for (size_t i = 1; i < currentRow.size(); i++) {
+        currentRow[i] = currentRow[i - 1] + Cost::insertCost(word[i - 1]);
+    }
 
     for (auto const& [key, childNode] : root->children) {
-       searchRecursive(childNode, key, word, currentRow, results, maxDist);
+       searchRecursive<Cost>(childNode, key, '\0', word, currentRow, nullptr, results, maxDist * Cost::scale,
+                             rowsVisited);
     }
 
     return results;
 }
+
+template vector<string> Trie::getSimilarWords<UnitCost>(const string& word, int maxDist, size_t* rowsVisited);
+template vector<string> Trie::getSimilarWords<KeyboardCost>(const string& word, int maxDist, size_t* rowsVisited);
+
+template<int K>
+void Trie::searchBanded(TrieNode* node, char letter, int depth, const string& target,
+                        const array<int, 2 * K + 1>& prevBand, vector<string>& results) {
+    // band[b] holds column i = depth - K + b; cells are saturated at K + 1
+    constexpr int width = 2 * K + 1;
+    constexpr int outOfRange = K + 1;
+    int columns = target.size();
+    
+    array<int, width> band;
+    int minRowCost = outOfRange;
+    
+#pragma GCC unroll 8
+    for (int b = 0; b < width; b++) {
+        int i = depth - K + b;
+        int cost = outOfRange;
+        if (i == 0) {
+            cost = depth;
+        } else if (i > 0 && i <= columns) {
+            int insertCost = b > 0 ? band[b - 1] + 1 : outOfRange;
+            int deleteCost = b + 1 < width ? prevBand[b + 1] + 1 : outOfRange;
+            int replaceCost = prevBand[b] + (target[i - 1] != letter);
+            cost = min({ insertCost, deleteCost, replaceCost });
+        }
+        band[b] = min(cost, outOfRange);
+        minRowCost = min(minRowCost, band[b]);
+    }
+    
+    if (minRowCost > K) {
+        return;
+    }
+    
+    int last = columns - depth + K;
+    if (node->isEndOfWord && last >= 0 && last < width && band[last] <= K) {
+        results.push_back(node->word);
+    }
+    
+    for (auto const& [key, childNode] : node->children) {
+        searchBanded<K>(childNode, key, depth + 1, target, band, results);
+    }
+}
+
+template<int K>
+vector<string> Trie::getSimilarWordsBanded(const string& word) {
+    vector<string> results;
+    
+    // Depth-0 row: column i costs i insertions
+    array<int, 2 * K + 1> band;
+    for (int b = 0; b < 2 * K + 1; b++) {
+        int i = b - K;
+        band[b] = (i >= 0 && i <= static_cast<int>(word.size())) ? min(i, K + 1) : K + 1;
+    }
+    
+    for (auto const& [key, childNode] : root->children) {
+        searchBanded<K>(childNode, key, 1, word, band, results);
+    }
+    
+    return results;
+}
+
+template vector<string> Trie::getSimilarWordsBanded<1>(const string& word);
+template vector<string> Trie::getSimilarWordsBanded<2>(const string& word);
+template vector<string> Trie::getSimilarWordsBanded<3>(const string& word);
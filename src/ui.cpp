@@ -82,14 +82,7 @@ void SpellCheckerUI::checkSingleWord() {
         cout << "\n✗ \"" << word << "\" is not in the dictionary.\n";
         cout << "\nSuggestions (" << currentMethod << "):\n";
         
-        vector<string> suggestions;
-        if (currentMethod == "trie") {
-            suggestions = checker->getSuggestionsTrie(word);
-        } else if (currentMethod == "kdtree") {
-            suggestions = checker->getSuggestionsKDTree(word);
-        } else {
-            suggestions = checker->getSuggestionsAStar(word);
-        }
+        vector<string> suggestions = checker->getEngine(currentMethod).suggest(word);
         
         if (suggestions.empty()) {
             cout << "  No suggestions found.\n";
@@ -149,29 +142,21 @@ void SpellCheckerUI::changeMethod() {
     cout << "\n=== Change Search Method ===\n";
     cout << "Current method: " << currentMethod << "\n\n";
     cout << "Available methods:\n";
-    cout << "  1. astar  - A* search with Levenshtein distance (recommended)\n";
-    cout << "  2. trie   - Direct Trie traversal with Levenshtein\n";
-    cout << "  3. kdtree - KD-Tree semantic similarity\n";
-    cout << "\nEnter method number (1-3): ";
+    const auto& engines = checker->getEngines();
+    for (size_t i = 0; i < engines.size(); i++) {
+        cout << "  " << (i + 1) << ". " << setw(8) << left << engines[i]->name() << right
+             << " - " << engines[i]->description() << "\n";
+    }
+    cout << "\nEnter method number (1-" << engines.size() << "): ";
     
     int choice;
     cin >> choice;
     
-    switch (choice) {
-        case 1:
-            currentMethod = "astar";
-            cout << "Method changed to: A* Search\n";
-            break;
-        case 2:
-            currentMethod = "trie";
-            cout << "Method changed to: Trie (Levenshtein)\n";
-            break;
-        case 3:
-            currentMethod = "kdtree";
-            cout << "Method changed to: KD-Tree (Semantic)\n";
-            break;
-        default:
-            cout << "Invalid choice. Method unchanged.\n";
+    if (choice >= 1 && choice <= static_cast<int>(engines.size())) {
+        currentMethod = engines[choice - 1]->name();
+        cout << "Method changed to: " << currentMethod << "\n";
+    } else {
+        cout << "Invalid choice. Method unchanged.\n";
     }
 }
 
@@ -0,0 +1,137 @@
+#include "../include/vptree.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+
+VPTree::VPTree(int dimensions) : embedding(dimensions) {}
+
+float VPTree::distance(const float* a, const float* b) const {
+    int dims = embedding.getDimensions();
+    float sum = 0.0f;
+    #ifdef _OPENMP
+    #pragma omp simd reduction(+:sum)
+    #endif
+    for (int d = 0; d < dims; d++) {
+        float diff = a[d] - b[d];
+        sum += diff * diff;
+    }
+    return sqrt(sum);
+}
+
+int VPTree::buildRecursive(vector<int>& ids, size_t begin, size_t end, vector<float>& scratch) {
+    if (begin >= end) return -1;
+    int dims = embedding.getDimensions();
+
+    // A scrambled but repeatable vantage point, moved to the front
+    size_t pick = begin + (static_cast<uint64_t>(begin) * 2654435761u + end) % (end - begin);
+    swap(ids[begin], ids[pick]);
+    int vantage = ids[begin];
+
+    int index = nodes.size();
+    nodes.push_back(Node{vantage, 0.0f, -1, -1});
+    if (end - begin == 1) return index;
+
+    // Split the rest at the median distance to the vantage point
+    const float* v = &vectors[static_cast<size_t>(vantage) * dims];
+    for (size_t i = begin + 1; i < end; i++) {
+        scratch[ids[i]] = distance(v, &vectors[static_cast<size_t>(ids[i]) * dims]);
+    }
+    size_t mid = begin + 1 + (end - begin - 1) / 2;
+    nth_element(ids.begin() + begin + 1, ids.begin() + mid, ids.begin() + end,
+                [&scratch](int a, int b) { return scratch[a] < scratch[b]; });
+    float radius = scratch[ids[mid]];
+
+    // nodes may reallocate during the recursion: store by index
+    int inside = buildRecursive(ids, begin + 1, mid, scratch);
+    int outside = buildRecursive(ids, mid, end, scratch);
+    nodes[index].radius = radius;
+    nodes[index].inside = inside;
+    nodes[index].outside = outside;
+    return index;
+}
+
+void VPTree::build(const vector<string>& wordList) {
+    clear();
+    words = wordList;
+    int dims = embedding.getDimensions();
+
+    vectors.resize(words.size() * dims);
+    for (size_t i = 0; i < words.size(); i++) {
+        embedding.embed(words[i], &vectors[i * dims]);
+    }
+
+    vector<int> ids(words.size());
+    for (size_t i = 0; i < ids.size(); i++) {
+        ids[i] = static_cast<int>(i);
+    }
+    vector<float> scratch(words.size());
+    nodes.reserve(words.size());
+    buildRecursive(ids, 0, ids.size(), scratch);
+}
+
+void VPTree::clear() {
+    vectors.clear();
+    nodes.clear();
+    words.clear();
+}
+
+vector<pair<double, string>> VPTree::findKNearest(const string& target_word, size_t k, size_t maxChecks,
+                                                  size_t* visited) const {
+    vector<pair<double, string>> results;
+    if (visited) *visited = 0;
+    if (nodes.empty() || k == 0) return results;
+
+    int dims = embedding.getDimensions();
+    vector<float> target = embedding.embed(target_word);
+    vector<pair<float, int>> heap;   // k best (distance, id), worst on top
+    heap.reserve(k);
+    auto tau = [&]() { return heap.size() < k ? INFINITY : heap.front().first; };
+
+    // Subtrees by the least distance any of their points can have, closest
+    // first. The inside of a node holds points within radius of its vantage
+    // point, so none is nearer than d - radius; the outside none nearer
+    // than radius - d
+    using Branch = pair<float, int>;
+    priority_queue<Branch, vector<Branch>, greater<Branch>> branches;
+    branches.push({0.0f, 0});
+    size_t checks = 0;
+    while (!branches.empty() && (maxChecks == 0 || checks < maxChecks)) {
+        auto [bound, node] = branches.top();
+        branches.pop();
+        if (bound > tau()) break;   // nothing closer is left
+
+        const Node& current = nodes[node];
+        float d = distance(target.data(), &vectors[static_cast<size_t>(current.point) * dims]);
+        checks++;
+        pair<float, int> candidate(d, current.point);
+        if (heap.size() < k) {
+            heap.push_back(candidate);
+            push_heap(heap.begin(), heap.end());
+        } else if (candidate < heap.front()) {
+            pop_heap(heap.begin(), heap.end());
+            heap.back() = candidate;
+            push_heap(heap.begin(), heap.end());
+        }
+
+        float insideBound = max(bound, d - current.radius);
+        float outsideBound = max(bound, current.radius - d);
+        if (current.inside >= 0 && insideBound <= tau()) branches.push({insideBound, current.inside});
+        if (current.outside >= 0 && outsideBound <= tau()) branches.push({outsideBound, current.outside});
+    }
+    if (visited) *visited = checks;
+
+    // Closest first, ties alphabetical
+    sort(heap.begin(), heap.end(), [this](const pair<float, int>& a, const pair<float, int>& b) {
+        if (a.first != b.first) return a.first < b.first;
+        return words[a.second] < words[b.second];
+    });
+    for (const auto& [dist, id] : heap) {
+        results.push_back({dist, words[id]});
+    }
+    return results;
+}
+
+size_t VPTree::memoryBytes() const {
+    return vectors.capacity() * sizeof(float) + nodes.capacity() * sizeof(Node);
+}
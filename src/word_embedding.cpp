@@ -0,0 +1,37 @@
+#include "../include/word_embedding.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+
+HashedBigramEmbedding::HashedBigramEmbedding(int dims) : dimensions(max(1, dims)) {}
+
+void HashedBigramEmbedding::embed(const string& word, float* out) const {
+    fill(out, out + dimensions, 0.0f);
+
+    // Boundary mark, then the lowercase word, then the other mark
+    unsigned char previous = '^';
+    for (size_t i = 0; i <= word.length(); i++) {
+        unsigned char current = i < word.length() ? tolower(static_cast<unsigned char>(word[i])) : '$';
+        uint32_t h = (static_cast<uint32_t>(previous) << 8 | current) * 2654435761u;   // Knuth multiplicative hash
+        out[(h >> 16) % dimensions] += (h & 0x8000) ? -1.0f : 1.0f;
+        previous = current;
+    }
+
+    float norm = 0.0f;
+    for (int d = 0; d < dimensions; d++) {
+        norm += out[d] * out[d];
+    }
+    if (norm > 0.0f) {
+        float scale = 1.0f / sqrt(norm);
+        for (int d = 0; d < dimensions; d++) {
+            out[d] *= scale;
+        }
+    }
+}
+
+vector<float> HashedBigramEmbedding::embed(const string& word) const {
+    vector<float> out(dimensions);
+    embed(word, out.data());
+    return out;
+}
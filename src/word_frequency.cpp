@@ -0,0 +1,57 @@
+#include "../include/word_frequency.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+uint8_t FrequencyStore::quantize(uint64_t count) {
+    double level = round(8.0 * log2(static_cast<double>(count) + 1.0));
+    return static_cast<uint8_t>(min(level, 255.0));
+}
+
+void FrequencyStore::setCount(int id, uint64_t count) {
+    if (id < 0) return;
+    if (id >= static_cast<int>(levels.size())) {
+        levels.resize(id + 1, 0);
+    }
+    levels[id] = quantize(count);
+}
+
+bool countCorpusWords(const string& corpusFile, const string& outputFile) {
+    ifstream corpus(corpusFile);
+    if (!corpus.is_open()) {
+        cerr << "Error: Could not open corpus file: " << corpusFile << endl;
+        return false;
+    }
+
+    unordered_map<string, uint64_t> counts;
+    string token;
+    while (corpus >> token) {
+        string word;
+        for (char c : token) {
+            if (isalpha(static_cast<unsigned char>(c))) {
+                word += tolower(static_cast<unsigned char>(c));
+            }
+        }
+        if (!word.empty()) counts[word]++;
+    }
+
+    vector<pair<string, uint64_t>> sorted(counts.begin(), counts.end());
+    sort(sorted.begin(), sorted.end(), [](const pair<string, uint64_t>& a, const pair<string, uint64_t>& b) {
+        if (a.second != b.second) return a.second > b.second;
+        return a.first < b.first;
+    });
+
+    ofstream out(outputFile);
+    if (!out.is_open()) {
+        cerr << "Error: Could not write frequency file: " << outputFile << endl;
+        return false;
+    }
+    for (const auto& [word, count] : sorted) {
+        out << word << " " << count << "\n";
+    }
+    cout << "Counted " << sorted.size() << " distinct words in " << corpusFile << "." << endl;
+    return true;
+}
@@ -0,0 +1,129 @@
+#include "../include/word_signature.h"
+#include "../include/simd_levenshtein.h"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define WORD_SIGNATURE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool passesFilter(uint32_t mask, int length, const WordSignature& target, int maxDist) {
+    return abs(length - target.length) <= maxDist &&
+           __builtin_popcount(mask & ~target.mask) <= maxDist &&
+           __builtin_popcount(target.mask & ~mask) <= maxDist;
+}
+
+#ifdef WORD_SIGNATURE_X86
+
+// Per-lane popcount of eight 32-bit masks: nibble lookup, then byte sums
+__attribute__((target("avx2")))
+__m256i popcount32(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowNibble));
+    __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble));
+    __m256i bytes = _mm256_add_epi8(low, high);
+    __m256i pairs = _mm256_maddubs_epi16(bytes, _mm256_set1_epi8(1));
+    return _mm256_madd_epi16(pairs, _mm256_set1_epi16(1));
+}
+
+// Two stages per block of 32 words: length and popcount bytes first (a
+// block where nothing survives is skipped whole), then the letter masks
+__attribute__((target("avx2")))
+size_t scanAVX2(const uint32_t* masks, const uint8_t* lengths, const uint8_t* popcounts, size_t count,
+                const WordSignature& target, int maxDist, vector<int>& ids) {
+    const __m256i limit8 = _mm256_set1_epi8(static_cast<char>(min(maxDist, 255)));
+    const __m256i targetLength = _mm256_set1_epi8(static_cast<char>(target.length));
+    const __m256i targetPopcount = _mm256_set1_epi8(static_cast<char>(target.popcount));
+    const __m256i targetMask = _mm256_set1_epi32(static_cast<int>(target.mask));
+    const __m256i limit32 = _mm256_set1_epi32(maxDist);
+
+    size_t block = 0;
+    for (; block + 32 <= count; block += 32) {
+        __m256i len = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lengths + block));
+        __m256i pop = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(popcounts + block));
+        __m256i lenDiff = _mm256_or_si256(_mm256_subs_epu8(len, targetLength), _mm256_subs_epu8(targetLength, len));
+        __m256i popDiff = _mm256_or_si256(_mm256_subs_epu8(pop, targetPopcount), _mm256_subs_epu8(targetPopcount, pop));
+        // max(diff, limit) == limit  <=>  diff <= limit
+        __m256i lenOk = _mm256_cmpeq_epi8(_mm256_max_epu8(lenDiff, limit8), limit8);
+        __m256i popOk = _mm256_cmpeq_epi8(_mm256_max_epu8(popDiff, limit8), limit8);
+        uint32_t survivors = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(lenOk, popOk)));
+        if (survivors == 0) continue;
+
+        for (int group = 0; group < 4; group++) {
+            uint32_t groupBits = (survivors >> (group * 8)) & 0xff;
+            if (groupBits == 0) continue;
+
+            __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + block + group * 8));
+            __m256i extra = popcount32(_mm256_andnot_si256(targetMask, mask));
+            __m256i missing = popcount32(_mm256_andnot_si256(mask, targetMask));
+            __m256i tooFar = _mm256_or_si256(_mm256_cmpgt_epi32(extra, limit32), _mm256_cmpgt_epi32(missing, limit32));
+            uint32_t near = ~static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(tooFar))) & groupBits;
+
+            while (near) {
+                int lane = __builtin_ctz(near);
+                ids.push_back(static_cast<int>(block + group * 8 + lane));
+                near &= near - 1;
+            }
+        }
+    }
+    return block;
+}
+
+#endif
+
+} // namespace
+
+WordSignature WordSignature::of(const string& word) {
+    WordSignature signature;
+    signature.mask = 0;
+    for (char c : word) {
+        unsigned letter = static_cast<unsigned char>(c) - 'a';
+        if (letter < 26) signature.mask |= 1u << letter;
+    }
+    signature.length = static_cast<uint8_t>(min<size_t>(word.length(), 255));
+    signature.popcount = static_cast<uint8_t>(__builtin_popcount(signature.mask));
+    return signature;
+}
+
+int SignatureTable::add(const string& word) {
+    WordSignature signature = WordSignature::of(word);
+    words.push_back(word);
+    masks.push_back(signature.mask);
+    lengths.push_back(signature.length);
+    popcounts.push_back(signature.popcount);
+    return static_cast<int>(words.size()) - 1;
+}
+
+void SignatureTable::clear() {
+    words.clear();
+    masks.clear();
+    lengths.clear();
+    popcounts.clear();
+}
+
+bool SignatureTable::mayMatch(int id, const WordSignature& target, int maxDist) const {
+    return passesFilter(masks[id], lengths[id], target, maxDist);
+}
+
+void SignatureTable::scan(const string& target, int maxDist, vector<int>& ids) const {
+    ids.clear();
+    WordSignature signature = WordSignature::of(target);
+
+    size_t start = 0;
+#ifdef WORD_SIGNATURE_X86
+    if (levenshteinKernelSupported(LevenshteinKernel::AVX2)) {
+        start = scanAVX2(masks.data(), lengths.data(), popcounts.data(), words.size(), signature, maxDist, ids);
+    }
+#endif
+
+    for (size_t i = start; i < words.size(); i++) {
+        if (passesFilter(masks[i], lengths[i], signature, maxDist)) {
+            ids.push_back(static_cast<int>(i));
+        }
+    }
+}
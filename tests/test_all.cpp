@@ -4,8 +4,12 @@
 #include <vector>
 #include "../include/trie.h"
 #include "../include/kdtree.h"
+#include "../include/flat_kdtree.h"
+#include "../include/vptree.h"
 #include "../include/astar_spellcheck.h"
 #include "../include/spellchecker.h"
+#include "../include/simd_levenshtein.h"
+#include "../include/cascade_engine.h"
 
 using namespace std;
 
@@ -108,6 +112,48 @@ TEST(test_trie_case_sensitivity) {
     ASSERT_FALSE(trie.contains("HELLO"));
 }
 
+TEST(test_trie_keyboard_cost_model) {
+    // Neighbouring keys and swapped letters cost half an edit
+    ASSERT_EQ(1, weightedEditDistance<KeyboardCost>("thw", "the"));
+    ASSERT_EQ(2, weightedEditDistance<KeyboardCost>("thw", "thy"));
+    ASSERT_EQ(1, weightedEditDistance<KeyboardCost>("teh", "the"));
+    ASSERT_EQ(2, weightedEditDistance<UnitCost>("teh", "the"));
+    
+    Trie trie;
+    trie.insert("the");
+    trie.insert("ten");
+    trie.insert("tea");
+    
+    // Half an edit of budget reaches the transposition and the adjacent key only
+    vector<string> similar = trie.getSimilarWords<KeyboardCost>("teh", 1);
+    ASSERT_TRUE(find(similar.begin(), similar.end(), "the") != similar.end());
+    ASSERT_TRUE(find(similar.begin(), similar.end(), "ten") != similar.end());
+    
+    SpellChecker checker(1, 5);
+    checker.addWord("thaw");
+    checker.addWord("the");
+    checker.addWord("thy");
+    ASSERT_TRUE(checker.getSuggestionsTrie("thw")[0] == "thaw");
+    checker.setCostModel(EditCostModel::Keyboard);
+    ASSERT_TRUE(checker.getSuggestionsTrie("thw")[0] == "the");
+    ASSERT_TRUE(checker.getSuggestionsAStar("thw")[0] == "the");
+}
+
+TEST(test_trie_banded_matches_generic) {
+    Trie trie;
+    for (const string w : {"hello", "hallo", "help", "helicopter", "hell", "he", "shell",
+                            "yellow", "world", "word", "sword", "a", "ab"}) {
+        trie.insert(w);
+    }
+    
+    // Same words in the same order as the generic DP, for every K
+    for (const string target : {"helo", "hel", "", "wrold", "helicoptr", "b", "yelow"}) {
+        ASSERT_TRUE(trie.getSimilarWordsBanded<1>(target) == trie.getSimilarWords(target, 1));
+        ASSERT_TRUE(trie.getSimilarWordsBanded<2>(target) == trie.getSimilarWords(target, 2));
+        ASSERT_TRUE(trie.getSimilarWordsBanded<3>(target) == trie.getSimilarWords(target, 3));
+    }
+}
+
 // ==================== KD-TREE TESTS ====================
 
 TEST(test_kdtree_insert_and_find) {
@@ -154,6 +200,46 @@ TEST(test_kdtree_similar_structure_words) {
     ASSERT_TRUE(foundSimilar);
 }
 
+TEST(test_vptree_bigram_index) {
+    vector<string> words;
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (const string tail : {"at", "ell", "ope", "ind"}) words.push_back(string(1, a) + tail);
+    }
+    VPTree tree(32);
+    tree.build(words);
+    ASSERT_EQ((size_t)words.size(), tree.size());
+    
+    // Exact search agrees with brute force over the embeddings
+    HashedBigramEmbedding embedding(32);
+    vector<float> target = embedding.embed("hellp");
+    vector<double> brute;
+    for (const string& w : words) {
+        vector<float> v = embedding.embed(w);
+        double sum = 0;
+        for (int i = 0; i < 32; i++) sum += (v[i] - target[i]) * (v[i] - target[i]);
+        brute.push_back(sqrt(sum));
+    }
+    sort(brute.begin(), brute.end());
+    vector<pair<double, string>> exact = tree.findKNearest("hellp", 5);
+    ASSERT_EQ((size_t)5, exact.size());
+    for (size_t i = 0; i < exact.size(); i++) {
+        ASSERT_TRUE(fabs(exact[i].first - brute[i]) < 1e-4);
+    }
+    ASSERT_TRUE(exact[0].second == "hell");
+    
+    // A check budget caps the distances computed
+    size_t visited = 0;
+    ASSERT_EQ((size_t)5, tree.findKNearest("hellp", 5, 20, &visited).size());
+    ASSERT_TRUE(visited <= 20);
+    
+    SpellChecker checker(2, 5);
+    for (const string& w : words) checker.addWord(w);
+    checker.setKDTreeBigrams(true, 32);
+    vector<string> suggestions = checker.getSuggestionsKDTree("hellp");
+    ASSERT_EQ((size_t)5, suggestions.size());
+    ASSERT_TRUE(suggestions[0] == "hell");
+}
+
 TEST(test_position_from_word) {
     Position pos = Position::fromWord("hello");
     
@@ -164,6 +250,270 @@ TEST(test_position_from_word) {
     for (double coord : pos.coords) {
         ASSERT_TRUE(coord >= -1.0 && coord <= 1.0);
     }
+    
+    // Length, vowel ratio, common letter ratio, a-m minus n-z, first letter
+    double expected[] = {0.25, 0.4, 0.4, 0.6, 8.0 / 26.0};
+    double coords[Position::DIMENSIONS];
+    Position::fromWord("hello", coords);
+    for (size_t d = 0; d < Position::DIMENSIONS; d++) {
+        ASSERT_TRUE(fabs(pos.coords[d] - expected[d]) < 1e-12);
+        ASSERT_TRUE(coords[d] == pos.coords[d]);
+    }
+    ASSERT_TRUE(Position::fromWord("Zoo").coords[3] == -1.0);
+    
+    // The batch version matches word by word
+    vector<string> words = {"hello", "Zoo", "", "it's", "123", "extraordinarily", "a", "queue", "rhythm",
+                            "Naïve", "supercalifragilistic", "ok"};
+    vector<float> columns[Position::DIMENSIONS];
+    float* out[Position::DIMENSIONS];
+    for (size_t d = 0; d < Position::DIMENSIONS; d++) {
+        columns[d].resize(words.size());
+        out[d] = columns[d].data();
+    }
+    Position::fromWords(words, out);
+    for (size_t i = 0; i < words.size(); i++) {
+        float single[Position::DIMENSIONS];
+        Position::fromWord(words[i], single);
+        for (size_t d = 0; d < Position::DIMENSIONS; d++) {
+            ASSERT_TRUE(columns[d][i] == single[d]);
+        }
+    }
+}
+
+TEST(test_kdtree_median_build) {
+    vector<string> words;
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (char b = 'a'; b <= 'z'; b++) words.push_back(string(1, a) + b + "ing");
+    }
+    KDTree inserted, balanced;
+    for (const string& w : words) inserted.insert(w);
+    balanced.build(words);
+    
+    // ceil(log2(n + 1)) levels, and the same neighbours as the inserted tree
+    ASSERT_EQ(words.size(), balanced.size());
+    ASSERT_EQ(10, (int)balanced.depth());
+    ASSERT_TRUE(inserted.depth() > balanced.depth());
+    for (const string q : {"hting", "zzing", "aing", "mmmmm"}) {
+        vector<Position> a = inserted.findKNearest(q, 3), b = balanced.findKNearest(q, 3);
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_TRUE(fabs(a[i].distance(Position::fromWord(q)) - b[i].distance(Position::fromWord(q))) < 1e-9);
+        }
+    }
+}
+
+TEST(test_kdtree_knn_exact) {
+    vector<string> words;
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (char b = 'a'; b <= 'z'; b += 3) words.push_back(string(1, a) + b + "ster");
+    }
+    KDTree tree;
+    for (const string& w : words) tree.insert(w);
+    
+    // The k nearest of a brute-force scan, for small and large k
+    for (size_t k : {1, 7, 40}) {
+        Position target = Position::fromWord("qxster");
+        vector<double> expected;
+        for (const string& w : words) expected.push_back(Position::fromWord(w).distance(target));
+        sort(expected.begin(), expected.end());
+        
+        size_t visited = 0;
+        vector<Position> found = tree.findKNearest("qxster", k, &visited);
+        ASSERT_EQ(k, found.size());
+        for (size_t i = 0; i < k; i++) {
+            ASSERT_TRUE(fabs(found[i].distance(target) - expected[i]) < 1e-9);
+        }
+        ASSERT_TRUE(visited <= words.size());
+    }
+}
+
+TEST(test_kdtree_best_bin_first) {
+    vector<string> words;
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (char b = 'a'; b <= 'z'; b++) words.push_back(string(1, a) + b + "ment");
+    }
+    KDTree tree;
+    tree.build(words);
+    
+    for (const string q : {"qument", "ament", "zzzzzzzz"}) {
+        Position target = Position::fromWord(q);
+        vector<Position> exact = tree.findKNearest(q, 5);
+        
+        // Without a budget the search is exact
+        vector<Position> unbounded = tree.findKNearestApprox(q, 5, 0);
+        ASSERT_EQ(exact.size(), unbounded.size());
+        for (size_t i = 0; i < exact.size(); i++) {
+            ASSERT_TRUE(fabs(exact[i].distance(target) - unbounded[i].distance(target)) < 1e-9);
+        }
+        
+        // With one, it stops after that many nodes, still closest first
+        size_t visited = 0;
+        vector<Position> bounded = tree.findKNearestApprox(q, 5, 10, &visited);
+        ASSERT_TRUE(visited <= 10);
+        ASSERT_EQ((size_t)5, bounded.size());
+        for (size_t i = 1; i < bounded.size(); i++) {
+            ASSERT_TRUE(bounded[i - 1].distance(target) <= bounded[i].distance(target));
+        }
+    }
+    
+    SpellChecker checker(2, 5);
+    for (const string& w : words) checker.addWord(w);
+    checker.setKDTreeChecks(20);
+    ASSERT_EQ((size_t)5, checker.getSuggestionsKDTree("qument").size());
+}
+
+TEST(test_kdtree_scapegoat_insert) {
+    // Sorted inserts: every word goes right of the last on the first axis
+    vector<string> words;
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (char b = 'a'; b <= 'z'; b++) {
+            for (const string tail : {"", "en", "ment"}) words.push_back(string(1, a) + b + tail);
+        }
+    }
+    KDTree unbalanced, balanced;
+    unbalanced.setBalanceFactor(1.0);
+    for (const string& w : words) {
+        unbalanced.insert(w);
+        balanced.insert(w);
+    }
+    ASSERT_EQ(words.size(), balanced.size());
+    ASSERT_TRUE(balanced.getRebuildCount() > 0);
+    ASSERT_EQ((size_t)0, unbalanced.getRebuildCount());
+    double bound = log(static_cast<double>(words.size())) / log(1.0 / KDTree::DEFAULT_BALANCE_FACTOR) + 1;
+    ASSERT_TRUE(balanced.depth() <= bound);
+    ASSERT_TRUE(balanced.depth() < unbalanced.depth());
+    
+    // Rebuilt subtrees keep every word reachable by an exact search
+    for (const string q : {"qument", "aa", "zzen"}) {
+        Position target = Position::fromWord(q);
+        vector<double> expected;
+        for (const string& w : words) expected.push_back(Position::fromWord(w).distance(target));
+        sort(expected.begin(), expected.end());
+        vector<Position> found = balanced.findKNearest(q, 5);
+        ASSERT_EQ((size_t)5, found.size());
+        for (size_t i = 0; i < found.size(); i++) {
+            ASSERT_TRUE(fabs(found[i].distance(target) - expected[i]) < 1e-9);
+        }
+    }
+}
+
+TEST(test_flat_kdtree_matches_kdtree) {
+    vector<string> words;
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (char b = 'a'; b <= 'z'; b++) words.push_back(string(1, a) + b + "ed");
+    }
+    KDTree tree;
+    tree.build(words);
+    FlatKDTree flat;
+    flat.build(words);
+    ASSERT_EQ(words.size(), flat.size());
+    
+    // Same neighbours, closest first, equally distant words in word order
+    // (many of these words share a position)
+    for (const string q : {"hted", "zzed", "aed", "mmmmm"}) {
+        Position target = Position::fromWord(q);
+        size_t treeVisited = 0, flatVisited = 0;
+        vector<Position> a = tree.findKNearest(q, 4, &treeVisited), b = flat.findKNearest(q, 4, &flatVisited);
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_TRUE(fabs(a[i].distance(target) - b[i].distance(target)) < 1e-5);
+            ASSERT_TRUE(a[i].word == b[i].word);
+        }
+        ASSERT_TRUE(flatVisited > 0 && flatVisited <= words.size());
+    }
+    
+    FlatKDTree empty;
+    ASSERT_TRUE(empty.findKNearest("word", 3).empty());
+}
+
+TEST(test_bucket_kdtree_leaf_sizes) {
+    vector<string> words;
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (char b = 'a'; b <= 'z'; b += 2) words.push_back(string(1, a) + b + "ful");
+    }
+    Position target = Position::fromWord("pzful");
+    vector<double> expected;
+    for (const string& w : words) expected.push_back(Position::fromWord(w).distance(target));
+    sort(expected.begin(), expected.end());
+    
+    // Any leaf size finds the brute-force neighbour distances, and the
+    // pointer tree's words among equally distant ones whatever the ids
+    KDTree pointerTree;
+    pointerTree.build(words);
+    vector<Position> pointerFound = pointerTree.findKNearest("pzful", 6);
+    vector<string> reversed(words.rbegin(), words.rend());
+    for (size_t leafSize : {1, 7, 32, 1000}) {
+        BucketKDTree tree(leafSize);
+        tree.build(reversed);
+        size_t scanned = 0;
+        vector<Position> found = tree.findKNearest("pzful", 6, &scanned);
+        ASSERT_EQ((size_t)6, found.size());
+        for (size_t i = 0; i < found.size(); i++) {
+            ASSERT_TRUE(fabs(found[i].distance(target) - expected[i]) < 1e-5);
+            ASSERT_TRUE(found[i].word == pointerFound[i].word);
+        }
+        ASSERT_TRUE(scanned >= 6 && scanned <= words.size());
+        
+        for (const string q : {"aful", "mmful", "zzzful"}) {
+            vector<Position> a = pointerTree.findKNearest(q, 6), b = tree.findKNearest(q, 6);
+            ASSERT_EQ(a.size(), b.size());
+            for (size_t i = 0; i < a.size(); i++) ASSERT_TRUE(a[i].word == b[i].word);
+        }
+    }
+    
+    // The checker's static tree gives the same suggestions as its pointer tree
+    SpellChecker checker(2, 5);
+    for (const string& w : words) checker.addWord(w);
+    vector<string> pointer = checker.getSuggestionsKDTree("pzful");
+    checker.setBucketKDTreeSearch(true);
+    ASSERT_TRUE(checker.getSuggestionsKDTree("pzful") == pointer);
+}
+
+TEST(test_bucket_kdtree_batch_queries) {
+    vector<string> words;
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (char b = 'a'; b <= 'z'; b++) words.push_back(string(1, a) + b + "ion");
+    }
+    BucketKDTree tree(8);
+    tree.build(words);
+    
+    // Batches (sequential or split over threads) match one query at a time
+    vector<string> queries = {"qzion", "aion", "motion", "zzzzz", "ab", "qzion"};
+    for (int threads : {1, 3}) {
+        vector<vector<Position>> batched = tree.findKNearestBatch(queries, 4, threads);
+        ASSERT_EQ(queries.size(), batched.size());
+        for (size_t i = 0; i < queries.size(); i++) {
+            vector<Position> single = tree.findKNearest(queries[i], 4);
+            ASSERT_EQ(single.size(), batched[i].size());
+            for (size_t j = 0; j < single.size(); j++) {
+                ASSERT_TRUE(single[j].word == batched[i][j].word);
+            }
+        }
+    }
+    ASSERT_TRUE(tree.findKNearestBatch({}, 4).empty());
+    
+    SpellChecker checker(2, 5);
+    for (const string& w : words) checker.addWord(w);
+    vector<vector<string>> suggestions = checker.getSuggestionsKDTreeBatch(queries, 2);
+    ASSERT_EQ(queries.size(), suggestions.size());
+    ASSERT_EQ((size_t)5, suggestions[0].size());
+    
+    // Each search mode batches to the same answers as its per-word query
+    for (bool bucket : {false, true}) {
+        checker.setBucketKDTreeSearch(bucket);
+        suggestions = checker.getSuggestionsKDTreeBatch(queries, 2);
+        for (size_t i = 0; i < queries.size(); i++) {
+            ASSERT_TRUE(suggestions[i] == checker.getSuggestionsKDTree(queries[i]));
+        }
+    }
+    
+    // A node budget makes the batch path answer word by word under it
+    checker.setBucketKDTreeSearch(false);
+    checker.setKDTreeChecks(2);
+    suggestions = checker.getSuggestionsKDTreeBatch(queries, 2);
+    for (size_t i = 0; i < queries.size(); i++) {
+        ASSERT_TRUE(suggestions[i] == checker.getSuggestionsKDTree(queries[i]));
+    }
 }
 
 // ==================== A* TESTS ====================
@@ -227,8 +577,174 @@ TEST(test_astar_no_match_within_distance) {
     ASSERT_TRUE(similar.empty());
 }
 
+TEST(test_astar_consecutive_insertions) {
+    Trie trie;
+    trie.insert("abbreviates");
+    trie.insert("abbreviation");
+    
+    // Two letters missing in a row: the cheap path to the inner states is
+    // found after a costlier one and must still be expanded
+    AStarSpellChecker checker(&trie);
+    vector<pair<int, string>> similar = checker.findSimilarWords("abbrvates", 2);
+    ASSERT_EQ(1, (int)similar.size());
+    ASSERT_TRUE(similar[0].second == "abbreviates");
+}
+
+TEST(test_astar_iterative_matches_full_search) {
+    Trie trie;
+    for (const string w : {"hello", "hallo", "help", "helot", "world", "yellow", "held"}) {
+        trie.insert(w);
+    }
+    
+    AStarSpellChecker checker(&trie);
+    
+    // "hello" is a single mid-word insertion away and must survive budget 1
+    vector<pair<int, string>> shallow = checker.findSimilarWordsIterative("helo", 1, 10);
+    bool foundHello = false;
+    for (const auto& [dist, word] : shallow) {
+        if (word == "hello") foundHello = (dist == 1);
+    }
+    ASSERT_TRUE(foundHello);
+    
+    vector<pair<int, string>> full = checker.findSimilarWords("helo", 2);
+    for (size_t k = 1; k <= full.size(); k++) {
+        vector<pair<int, string>> iterative = checker.findSimilarWordsIterative("helo", 2, k);
+        ASSERT_EQ(k, iterative.size());
+        for (size_t i = 0; i < k; i++) {
+            ASSERT_TRUE(iterative[i] == full[i]);
+        }
+    }
+    
+    // A budget-2 pass reaches "abbreviates" only if states first popped on
+    // a costlier path are expanded again when the cheaper one arrives
+    Trie longWords;
+    longWords.insert("abbreviates");
+    longWords.insert("abbreviation");
+    AStarSpellChecker longChecker(&longWords);
+    vector<pair<int, string>> deep = longChecker.findSimilarWordsIterative("abbrvates", 2, 10);
+    ASSERT_EQ(1, (int)deep.size());
+    ASSERT_TRUE(deep[0] == make_pair(2, string("abbreviates")));
+}
+
+TEST(test_astar_search_context_reuse) {
+    Trie trie;
+    for (const string w : {"hello", "hallo", "help", "world", "word", "sword"}) {
+        trie.insert(w);
+    }
+    
+    AStarSpellChecker checker(&trie);
+    SearchContext context;
+    
+    // Alternate queries through one context; each must match a fresh search
+    for (int round = 0; round < 3; round++) {
+        for (const string query : {"helo", "wrld", "xyz"}) {
+            vector<pair<int, string>> fresh = checker.findSimilarWords(query, 2);
+            const auto& reused = checker.findSimilarWords(query, 2, context);
+            ASSERT_EQ(fresh.size(), reused.size());
+            for (size_t i = 0; i < fresh.size(); i++) {
+                ASSERT_EQ(fresh[i].first, reused[i].first);
+                ASSERT_TRUE(fresh[i].second == reused[i].second->word);
+            }
+        }
+    }
+}
+
+// ==================== EDIT DISTANCE KERNEL TESTS ====================
+
+TEST(test_levenshtein_kernels_agree) {
+    LevenshteinScratch scratch;
+    ASSERT_EQ(3, simdLevenshtein("kitten", "sitting", scratch));
+    ASSERT_EQ(5, simdLevenshtein("", "hello", scratch));
+    ASSERT_EQ(0, simdLevenshtein("same", "same", scratch));
+    
+    // Every supported kernel must match the scalar DP, across both lane widths
+    unsigned seed = 7;
+    auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return (seed >> 16) & 0x7fff; };
+    for (int length : {1, 2, 5, 17, 33, 64, 130, 254, 255, 300}) {
+        for (int trial = 0; trial < 4; trial++) {
+            string a, b;
+            for (int i = 0; i < length; i++) a += char('a' + next() % 4);
+            int otherLength = max(1, length + (int)(next() % 9) - 4);
+            for (int i = 0; i < otherLength; i++) b += char('a' + next() % 4);
+            
+            int expected = levenshteinWithKernel(LevenshteinKernel::Scalar, a, b, scratch);
+            ASSERT_EQ(expected, levenshteinWithKernel(LevenshteinKernel::SSE41, a, b, scratch));
+            ASSERT_EQ(expected, levenshteinWithKernel(LevenshteinKernel::AVX2, a, b, scratch));
+        }
+    }
+}
+
+TEST(test_batch_levenshtein_matches_pairwise) {
+    // More candidates than one vector of lanes, of mixed lengths, incl. one over 255
+    vector<string> words;
+    unsigned seed = 11;
+    auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return (seed >> 16) & 0x7fff; };
+    for (int i = 0; i < 70; i++) {
+        string w;
+        int length = 1 + next() % 14;
+        for (int j = 0; j < length; j++) w += char('a' + next() % 5);
+        words.push_back(w);
+    }
+    words.push_back("");
+    words.push_back(string(300, 'a'));
+    
+    vector<const string*> candidates;
+    for (const auto& w : words) candidates.push_back(&w);
+    
+    LevenshteinScratch scratch;
+    CandidateBatchScratch batch;
+    vector<int> distances;
+    string target = "abcdeab";
+    
+    batchLevenshtein(target, candidates, distances, batch);
+    for (size_t i = 0; i < words.size(); i++) {
+        ASSERT_EQ(levenshteinWithKernel(LevenshteinKernel::Scalar, target, words[i], scratch), distances[i]);
+    }
+    
+    // Bounded: anything beyond the bound is reported as bound + 1
+    batchLevenshtein(target, candidates, distances, batch, 2);
+    for (size_t i = 0; i < words.size(); i++) {
+        int expected = levenshteinWithKernel(LevenshteinKernel::Scalar, target, words[i], scratch);
+        ASSERT_EQ(min(expected, 3), distances[i]);
+    }
+}
+
 // ==================== SPELLCHECKER TESTS ====================
 
+TEST(test_signature_filter_is_lower_bound) {
+    SignatureTable table;
+    vector<string> words = {"hello", "hallo", "help", "world", "shell", "lohel", "abcdefghijklmnopqrstuvwxyz",
+                            "he", "helloooo", "yellow", "jello", "hxllo"};
+    // Pad past one 32-word SIMD block so both scan paths run
+    for (int i = 0; i < 40; i++) words.push_back("w" + to_string(i % 10) + string(i % 7, 'e') + "lo");
+    for (const auto& w : words) table.add(w);
+    
+    LevenshteinScratch scratch;
+    for (const string target : {"helo", "hello", "wrld", "yelow"}) {
+        for (int maxDist = 0; maxDist <= 3; maxDist++) {
+            vector<int> ids;
+            table.scan(target, maxDist, ids);
+            vector<bool> passed(words.size(), false);
+            for (int id : ids) passed[id] = true;
+            
+            // Never rejects a true match, and scan agrees with mayMatch
+            WordSignature signature = WordSignature::of(target);
+            for (size_t i = 0; i < words.size(); i++) {
+                if (simdLevenshtein(target, words[i], scratch) <= maxDist) ASSERT_TRUE(passed[i]);
+                ASSERT_EQ(table.mayMatch(i, signature, maxDist), passed[i]);
+            }
+        }
+    }
+    
+    SpellChecker checker(1, 5);
+    for (const auto& w : {"hello", "hallo", "help", "world"}) checker.addWord(w);
+    checker.addWord("hello");
+    ASSERT_EQ(4, checker.getDictionarySize());
+    vector<string> scan = checker.getSuggestionsScan("helo");
+    ASSERT_EQ(2, (int)scan.size());
+    ASSERT_TRUE(scan[0] == "hello" && scan[1] == "help");
+}
+
 TEST(test_spellchecker_valid_word) {
     SpellChecker checker(2, 5);
     checker.addWord("hello");
@@ -269,6 +785,256 @@ TEST(test_spellchecker_suggestions_astar) {
     ASSERT_TRUE(suggestions.size() >= 1);
 }
 
+TEST(test_spellchecker_suggestions_symspell) {
+    SpellChecker checker(2, 50);
+    for (const auto& w : {"hello", "hallo", "help", "world", "word", "sword", "yellow", "helicopter", "hell"}) {
+        checker.addWord(w);
+    }
+    
+    // Same suggestions as the exhaustive scan, including after the index goes stale
+    ASSERT_TRUE(checker.getSuggestionsSymSpell("helo") == checker.getSuggestionsScan("helo"));
+    ASSERT_TRUE(checker.getSuggestionsSymSpell("wrold") == checker.getSuggestionsScan("wrold"));
+    checker.addWord("halo");
+    vector<string> suggestions = checker.getSuggestionsSymSpell("helo");
+    ASSERT_TRUE(suggestions == checker.getSuggestionsScan("helo"));
+    ASSERT_TRUE(find(suggestions.begin(), suggestions.end(), "halo") != suggestions.end());
+    
+    SpellCheckResult result = checker.checkText("helo wrld", "symspell");
+    ASSERT_EQ(2, result.incorrectWords);
+    ASSERT_FALSE(result.errors[0].suggestions.empty());
+}
+
+TEST(test_spellchecker_suggestions_bktree) {
+    BKTree bk;
+    vector<string> words = {"hello", "hallo", "help", "world", "word", "sword", "yellow", "helicopter", "hell", "he"};
+    for (const auto& w : words) bk.insert(w);
+    bk.insert("hello");
+    ASSERT_EQ(words.size(), bk.size());
+    
+    // Exactly the words a linear scan finds, with pruning skipping some distances
+    LevenshteinScratch scratch;
+    for (const string query : {"helo", "wrold", "x", "helicoptr"}) {
+        vector<pair<int, string>> found;
+        size_t computed = 0;
+        bk.search(query, 2, found, &computed);
+        sort(found.begin(), found.end());
+        
+        vector<pair<int, string>> expected;
+        for (const auto& w : words) {
+            int d = simdLevenshtein(query, w, scratch);
+            if (d <= 2) expected.push_back({d, w});
+        }
+        sort(expected.begin(), expected.end());
+        ASSERT_TRUE(found == expected);
+        ASSERT_TRUE(computed <= words.size());
+    }
+    
+    SpellChecker checker(2, 5);
+    for (const auto& w : words) checker.addWord(w);
+    ASSERT_TRUE(checker.getSuggestionsBKTree("helo") == checker.getSuggestionsScan("helo"));
+}
+
+TEST(test_spellchecker_suggestions_qgram) {
+    vector<string> words = {"internationalization", "internationalize", "international", "nationalization",
+                            "hello", "help", "he", "a", "ab", "characterization", "characteristic"};
+    QGramIndex index(2);
+    index.build(words);
+    QGramIndex::LookupContext context;
+    LevenshteinScratch scratch;
+    
+    // The count filter never drops a word within maxDist
+    for (const string query : {"internationalisation", "internatinalization", "helo", "b", "", "charcterization"}) {
+        for (int maxDist = 0; maxDist <= 3; maxDist++) {
+            vector<int> ids;
+            index.lookup(query, maxDist, ids, context);
+            for (size_t id = 0; id < words.size(); id++) {
+                if (simdLevenshtein(query, words[id], scratch) <= maxDist) {
+                    ASSERT_TRUE(find(ids.begin(), ids.end(), (int)id) != ids.end());
+                }
+            }
+        }
+    }
+    ASSERT_TRUE(index.memoryBytes() > 0);
+    
+    SpellChecker checker(2, 5);
+    for (const auto& w : words) checker.addWord(w);
+    ASSERT_TRUE(checker.getSuggestionsQGram("internatinalisation") == checker.getSuggestionsScan("internatinalisation"));
+    ASSERT_TRUE(checker.getSuggestionsQGram("helo") == checker.getSuggestionsScan("helo"));
+}
+
+TEST(test_spellchecker_phonetic_merge) {
+    ASSERT_TRUE(doubleMetaphone("phone").primary == doubleMetaphone("fone").primary);
+    ASSERT_TRUE(doubleMetaphone("night").primary == "NT");
+    ASSERT_TRUE(doubleMetaphone("thomas").primary == "TMS");
+    ASSERT_TRUE(doubleMetaphone("smith").alternate == "XMT");
+    
+    SpellChecker checker(1, 3);
+    for (const string w : {"physics", "phone", "fizzy", "fix", "six", "mix"}) checker.addWord(w);
+    
+    // Two edits away: only the phonetic index finds it
+    SpellCheckResult plain = checker.checkText("fysics", "trie");
+    ASSERT_TRUE(find(plain.errors[0].suggestions.begin(), plain.errors[0].suggestions.end(), "physics") ==
+                plain.errors[0].suggestions.end());
+    checker.setPhoneticMerge(true);
+    SpellCheckResult merged = checker.checkText("fysics", "trie");
+    ASSERT_TRUE(find(merged.errors[0].suggestions.begin(), merged.errors[0].suggestions.end(), "physics") !=
+                merged.errors[0].suggestions.end());
+    ASSERT_TRUE(merged.errors[0].suggestions.size() <= 3);
+}
+
+// Suggests the word reversed, to tell it apart from the built-in engines
+class ReverseEngine final : public SuggestionEngine {
+    string engineName = "reverse";
+public:
+    const string& name() const override { return engineName; }
+    const string& description() const override { return engineName; }
+    vector<string> suggest(const string& word) override { return {string(word.rbegin(), word.rend())}; }
+};
+
+TEST(test_spellchecker_engine_registry) {
+    SpellChecker checker(2, 5);
+    for (const string w : {"hello", "help", "world"}) checker.addWord(w);
+    
+    // Name lookup and the compile-time path agree
+    TrieEngine trie(checker, "trie", "");
+    SpellCheckResult byName = checker.checkText("helo wrld", "trie");
+    SpellCheckResult direct = checker.checkText("helo wrld", trie);
+    ASSERT_EQ(2, (int)byName.errors.size());
+    ASSERT_TRUE(byName.errors[0].suggestions == direct.errors[0].suggestions);
+    ASSERT_TRUE(byName.errors[1].suggestions == direct.errors[1].suggestions);
+
+    // A caller-owned search context gives the same A* suggestions
+    SearchContext context;
+    SuggestionEngine& astar = checker.getEngine("astar");
+    ASSERT_TRUE(astar.suggest("helo", context) == astar.suggest("helo"));
+    ASSERT_TRUE(astar.suggest("wrld", context) == astar.suggest("wrld"));
+    
+    // Batches give the per-word answers, through the default loop and the
+    // kd-tree's shared walk alike
+    vector<SearchContext> contexts(2);
+    vector<string> words = {"helo", "wrld", "help"};
+    for (const string method : {"astar", "kdtree"}) {
+        SuggestionEngine& engine = checker.getEngine(method);
+        vector<vector<string>> batch = engine.suggestBatch(words, contexts);
+        ASSERT_EQ(words.size(), batch.size());
+        for (size_t i = 0; i < words.size(); i++) {
+            ASSERT_TRUE(batch[i] == engine.suggest(words[i]));
+        }
+    }
+
+    // A registered engine is reachable by name; unknown names fall back to A*
+    checker.registerEngine(make_unique<ReverseEngine>());
+    SpellCheckResult custom = checker.checkText("wrld", "reverse");
+    ASSERT_TRUE(custom.errors[0].method == "reverse");
+    ASSERT_TRUE(custom.errors[0].suggestions == vector<string>{"dlrw"});
+    ASSERT_TRUE(checker.getEngine("nonexistent").name() == "astar");
+    ASSERT_TRUE(checker.findEngine("nonexistent") == nullptr);
+}
+
+TEST(test_spellchecker_cascade) {
+    SpellChecker checker(2, 5);
+    for (const string w : {"hello", "hell", "help", "world", "word", "phone", "zebra"}) checker.addWord(w);
+    CascadeEngine cascade(checker, 2);
+    
+    // Two distance-1 matches are enough: later stages never run
+    vector<string> close = cascade.suggest("helo");
+    ASSERT_TRUE(close.size() >= 2);
+    ASSERT_TRUE(close[0] == "hello" || close[0] == "hell" || close[0] == "help");
+    vector<CascadeStageStats> stats = cascade.getStageStats();
+    ASSERT_EQ(1, (int)stats[0].reached);
+    ASSERT_EQ(1, (int)stats[0].resolved);
+    ASSERT_EQ(0, (int)stats[1].reached);
+    
+    // Nothing within two edits: escalates to the phonetic stage
+    vector<string> far = cascade.suggest("fon");
+    ASSERT_TRUE(find(far.begin(), far.end(), "phone") != far.end());
+    ASSERT_EQ(2, (int)cascade.getQueryCount());
+    
+    // A zero budget stops after the first stage
+    cascade.resetStats();
+    cascade.setLatencyBudgetUs(0);
+    cascade.suggest("qqqqqq");
+    ASSERT_EQ(1, (int)cascade.getBudgetStops());
+    ASSERT_EQ(0, (int)cascade.getStageStats()[1].reached);
+}
+
+TEST(test_spellchecker_frequency_ranking) {
+    ASSERT_EQ(0, (int)FrequencyStore::quantize(0));
+    ASSERT_TRUE(FrequencyStore::quantize(1000) < FrequencyStore::quantize(100000));
+    ASSERT_EQ(255, (int)FrequencyStore::quantize(UINT64_MAX));
+    
+    SpellChecker checker(2, 2);
+    for (const string w : {"bat", "cat", "hat", "rat"}) checker.addWord(w);
+    
+    // Four words one edit away: without counts the first two alphabetically,
+    // with counts the two most frequent, in every engine
+    ASSERT_TRUE(checker.getSuggestionsSymSpell("xat") == (vector<string>{"bat", "cat"}));
+    checker.setWordFrequency("rat", 5000);
+    checker.setWordFrequency("hat", 200);
+    checker.setWordFrequency("unknown", 10);
+    vector<string> expected = {"rat", "hat"};
+    
+    // Words are looked up cleaned, in either direction
+    checker.setWordFrequency("Cat", 50);
+    ASSERT_EQ((int)FrequencyStore::quantize(50), checker.getWordFrequencyLevel("CAT"));
+    ASSERT_EQ((int)FrequencyStore::quantize(5000), checker.getWordFrequencyLevel("Rat"));
+    ASSERT_EQ(0, checker.getWordFrequencyLevel("Unknown"));
+    for (const string method : {"trie", "astar", "symspell", "bktree", "qgram"}) {
+        ASSERT_TRUE(checker.getEngine(method).suggest("xat") == expected);
+    }
+    
+    // A frequent enough word at distance 1 ends iterative deepening there,
+    // before the distance-2 words fill the list
+    ASSERT_EQ(2, (int)checker.getSuggestionsAStar("rax").size());
+    checker.setEarlyStopFrequency(FrequencyStore::quantize(1000));
+    ASSERT_TRUE(checker.getSuggestionsAStar("rax") == vector<string>{"rat"});
+}
+
+TEST(test_spellchecker_length_partitions) {
+    SpellChecker checker(2, 50);
+    for (const string w : {"a", "at", "cat", "cart", "carts", "cartel", "scatter", "catalogue", "hello", "help"}) {
+        checker.addWord(w);
+    }
+    vector<string> queries = {"ca", "cat", "crt", "carst", "catalog", "hep", "zzzzzzzzzzzz"};
+    
+    // The shards find exactly the words the full scan finds, sequential or
+    // parallel, including words added after partitioning; the kd-tree only
+    // returns words from the relevant lengths
+    for (bool parallel : {false, true}) {
+        checker.setLengthPartitioning(true, parallel);
+        checker.addWord(parallel ? "carte" : "cast");
+        for (const string& q : queries) {
+            ASSERT_TRUE(checker.getSuggestionsTrie(q) == checker.getSuggestionsScan(q));
+            for (const string& s : checker.getSuggestionsKDTree(q)) {
+                ASSERT_TRUE(abs((int)s.length() - (int)q.length()) <= 2);
+            }
+        }
+    }
+    checker.setLengthPartitioning(false);
+    ASSERT_FALSE(checker.getLengthPartitioning());
+}
+
+TEST(test_spellchecker_kdtree_rerank) {
+    SpellChecker checker(2, 5);
+    for (char a = 'a'; a <= 'z'; a++) {
+        for (char b = 'a'; b <= 'e'; b++) checker.addWord(string(1, a) + b + "llo");
+    }
+    for (const string w : {"hello", "help", "held", "yellow"}) checker.addWord(w);
+    
+    // The grid words crowd the kd-tree around the query, so the fetch
+    // widens until it reaches the real matches. Re-ranked: edit-distance
+    // order among the verified neighbours, then the nearest unverified ones
+    // to keep maxSuggestions
+    checker.setKDTreeRerank(true);
+    vector<string> reranked = checker.getSuggestionsKDTree("hellp");
+    ASSERT_EQ((size_t)5, reranked.size());
+    ASSERT_TRUE(reranked[0] == "hello" || reranked[0] == "help");
+    ASSERT_TRUE(simdLevenshtein("hellp", reranked[0]) <= simdLevenshtein("hellp", reranked[2]));
+    
+    checker.setKDTreeRerank(false);
+    ASSERT_EQ((size_t)5, checker.getSuggestionsKDTree("hellp").size());
+}
+
 TEST(test_spellchecker_check_text) {
     SpellChecker checker(2, 5);
     checker.addWord("the");
@@ -301,11 +1067,21 @@ int main() {
     RUN_TEST(test_trie_similar_words);
     RUN_TEST(test_trie_empty_word);
     RUN_TEST(test_trie_case_sensitivity);
+    RUN_TEST(test_trie_keyboard_cost_model);
+    RUN_TEST(test_trie_banded_matches_generic);
     
     cout << "\n=== KD-Tree Tests ===\n";
     RUN_TEST(test_kdtree_insert_and_find);
     RUN_TEST(test_kdtree_find_k_nearest);
     RUN_TEST(test_kdtree_similar_structure_words);
+    RUN_TEST(test_kdtree_median_build);
+    RUN_TEST(test_kdtree_knn_exact);
+    RUN_TEST(test_kdtree_best_bin_first);
+    RUN_TEST(test_kdtree_scapegoat_insert);
+    RUN_TEST(test_flat_kdtree_matches_kdtree);
+    RUN_TEST(test_bucket_kdtree_leaf_sizes);
+    RUN_TEST(test_bucket_kdtree_batch_queries);
+    RUN_TEST(test_vptree_bigram_index);
     RUN_TEST(test_position_from_word);
     
     cout << "\n=== A* Search Tests ===\n";
@@ -313,12 +1089,29 @@ int main() {
     RUN_TEST(test_astar_find_similar);
     RUN_TEST(test_astar_best_match);
     RUN_TEST(test_astar_no_match_within_distance);
+    RUN_TEST(test_astar_consecutive_insertions);
+    RUN_TEST(test_astar_iterative_matches_full_search);
+    RUN_TEST(test_astar_search_context_reuse);
+    
+    cout << "\n=== Edit Distance Kernel Tests ===\n";
+    RUN_TEST(test_levenshtein_kernels_agree);
+    RUN_TEST(test_batch_levenshtein_matches_pairwise);
     
     cout << "\n=== SpellChecker Tests ===\n";
+    RUN_TEST(test_signature_filter_is_lower_bound);
     RUN_TEST(test_spellchecker_valid_word);
     RUN_TEST(test_spellchecker_suggestions_trie);
     RUN_TEST(test_spellchecker_suggestions_kdtree);
     RUN_TEST(test_spellchecker_suggestions_astar);
+    RUN_TEST(test_spellchecker_suggestions_symspell);
+    RUN_TEST(test_spellchecker_suggestions_bktree);
+    RUN_TEST(test_spellchecker_suggestions_qgram);
+    RUN_TEST(test_spellchecker_phonetic_merge);
+    RUN_TEST(test_spellchecker_engine_registry);
+    RUN_TEST(test_spellchecker_cascade);
+    RUN_TEST(test_spellchecker_frequency_ranking);
+    RUN_TEST(test_spellchecker_length_partitions);
+    RUN_TEST(test_spellchecker_kdtree_rerank);
     RUN_TEST(test_spellchecker_check_text);
     
     cout << "\n";